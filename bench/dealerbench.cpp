@@ -0,0 +1,109 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+// own
+#include "src/engine/dealeroutcomes.hpp"
+#include "src/widgets/cards.hpp"
+
+/**
+ * @brief Compares the memoized dealer outcomes with the plain recursion over the compositions of dealt shoes.
+ *
+ * Every shoe is dealt to 75% in steps of a few cards, and at every step the outcomes of all ten upcards are
+ * computed from the remaining composition, once by DealerOutcomes::computeUncached and twice from one cache
+ * shared by the whole run, cold and warm. Usage: dealer-bench [shoes] [budget in MiB]
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    qint32 shoes = 20;
+    qint64 budget = 4;
+    if (argc > 1) {
+        shoes = qMax(1, QString(argv[1]).toInt());
+    }
+    if (argc > 2) {
+        budget = qMax(1, QString(argv[2]).toInt());
+    }
+
+    QTextStream out(stdout);
+    out << "decks,shoes,compositions,uncached_ms,cached_ms,warm_ms,speedup,lookups,hit_rate,entries,evictions,kib,"
+           "max_error\n";
+    for (qint32 deckCount: {1, 2, 6, 8}) {
+        QRandomGenerator generator(quint32(deckCount));
+        QVector<QVector<qint32>> compositions;
+        for (qint32 shoe = 0; shoe < shoes; shoe++) {
+            const QList<qint32> cards = Cards::shuffleCards(deckCount, generator);
+            QVector<qint32> composition = DealerOutcomes::fullShoe(deckCount);
+            for (qint32 position = 0; position < cards.size() * 3 / 4; position++) {
+                const qint32 rank = Cards::getRank(cards[position]);
+                if (rank != Cards::Rank::Joker) {
+                    composition[rank - Cards::Rank::Ace]--;
+                }
+                if (position % 5 == 0) {
+                    compositions.push_back(composition);
+                }
+            }
+        }
+
+        const Rules rules;
+        QVector<double> expected;
+        QElapsedTimer timer;
+        timer.start();
+        for (const QVector<qint32> &composition: qAsConst(compositions)) {
+            for (qint32 upcard = 1; upcard <= 10; upcard++) {
+                expected.push_back(DealerOutcomes::computeUncached(rules, composition, upcard)
+                                           .probability(DealerOutcomes::Bust));
+            }
+        }
+        const qint64 uncachedNsecs = timer.nsecsElapsed();
+
+        DealerOutcomes outcomes(rules, budget << 20);
+        double maxError = 0;
+        qint32 index = 0;
+        timer.restart();
+        for (const QVector<qint32> &composition: qAsConst(compositions)) {
+            for (qint32 upcard = 1; upcard <= 10; upcard++) {
+                const double bust = outcomes.compute(composition, upcard).probability(DealerOutcomes::Bust);
+                maxError = qMax(maxError, qAbs(bust - expected[index++]));
+            }
+        }
+        const qint64 cachedNsecs = timer.nsecsElapsed();
+        // the statistics of the cold pass, the warm one is all hits
+        const DealerOutcomes::Stats stats = outcomes.stats();
+        timer.restart();
+        for (const QVector<qint32> &composition: qAsConst(compositions)) {
+            for (qint32 upcard = 1; upcard <= 10; upcard++) {
+                outcomes.compute(composition, upcard);
+            }
+        }
+        const qint64 warmNsecs = timer.nsecsElapsed();
+
+        out << deckCount << ',' << shoes << ',' << compositions.size() << ','
+            << uncachedNsecs / 1e6 << ',' << cachedNsecs / 1e6 << ',' << warmNsecs / 1e6 << ','
+            << double(uncachedNsecs) / qMax(qint64(1), cachedNsecs) << ','
+            << stats.lookups << ',' << stats.hitRate() << ',' << stats.entries << ',' << stats.evictions << ','
+            << stats.bytes / 1024 << ',' << maxError << '\n';
+    }
+    return 0;
+}
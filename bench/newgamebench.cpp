@@ -0,0 +1,80 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <algorithm>
+// Qt
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+// KF
+#include <KLocalizedString>
+// own
+#include "src/table/table.hpp"
+
+/**
+ * @brief Measures how long "New Game" takes for every standard difficulty level.
+ *
+ * The table is created on the offscreen platform, so the numbers include the layout and paint work
+ * triggered by Table::createNewGame but no window system overhead. Usage: newgame-bench [iterations]
+ */
+int main(int argc, char *argv[]) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    KLocalizedString::setApplicationDomain("card-counter");
+
+    qint32 iterations = 200;
+    if (argc > 1) {
+        iterations = qMax(1, QString(argv[1]).toInt());
+    }
+
+    Table table;
+    table.resize(1280, 800);
+    table.show();
+    QApplication::processEvents();
+
+    const QVector<QPair<KgDifficultyLevel::StandardLevel, QString>> levels = {
+            {KgDifficultyLevel::Easy,   QStringLiteral("Easy")},
+            {KgDifficultyLevel::Medium, QStringLiteral("Medium")},
+            {KgDifficultyLevel::Hard,   QStringLiteral("Hard")},
+            {KgDifficultyLevel::Custom, QStringLiteral("Nightmare")},
+    };
+
+    QTextStream out(stdout);
+    out << "level,iterations,min_us,median_us,p95_us,max_us\n";
+    for (const auto &level: levels) {
+        QVector<qint64> samples;
+        samples.reserve(iterations);
+        for (qint32 i = 0; i < iterations; i++) {
+            QElapsedTimer timer;
+            timer.start();
+            table.createNewGame(level.first);
+            QApplication::processEvents();
+            samples.push_back(timer.nsecsElapsed() / 1000);
+        }
+        std::sort(samples.begin(), samples.end());
+        out << level.second << ',' << iterations << ','
+            << samples.first() << ','
+            << samples[samples.size() / 2] << ','
+            << samples[qMin(samples.size() - 1, qint32(samples.size() * 0.95))] << ','
+            << samples.last() << '\n';
+    }
+    return 0;
+}
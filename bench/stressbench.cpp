@@ -0,0 +1,220 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <algorithm>
+#include <numeric>
+// POSIX
+#include <sys/resource.h>
+// Qt
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QTimer>
+// KDEGames
+#include <KgDifficulty>
+// KF
+#include <KLocalizedString>
+// own
+#include "src/table/table.hpp"
+#include "src/table/tableslot.hpp"
+#include "src/table/dealscheduler.hpp"
+
+/**
+ * @brief Collects the time spent while dispatching a kind of event.
+ */
+struct EventTimes {
+    QVector<qint64> samples; ///< The dispatch times in nanoseconds.
+
+    qint64 total() const {
+        return std::accumulate(samples.begin(), samples.end(), qint64(0));
+    }
+
+    qint64 percentile(double p) {
+        if (samples.empty()) {
+            return 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[qMin(samples.size() - 1, qint32(samples.size() * p))];
+    }
+};
+
+/**
+ * @brief QApplication that measures how long the deal ticks, paints and layout passes take.
+ */
+class BenchApplication : public QApplication {
+public:
+    BenchApplication(int &argc, char **argv) : QApplication(argc, argv) {}
+
+    bool notify(QObject *receiver, QEvent *event) override {
+        EventTimes *times = nullptr;
+        switch (event->type()) {
+            case QEvent::Paint:
+                times = &paints;
+                break;
+            case QEvent::LayoutRequest:
+                times = &layouts;
+                break;
+            case QEvent::Timer:
+                // the timer of the deal scheduler
+                if (scheduler && receiver->parent() == scheduler) {
+                    times = &ticks;
+                }
+                break;
+            default:
+                break;
+        }
+        if (!times) {
+            return QApplication::notify(receiver, event);
+        }
+        QElapsedTimer timer;
+        timer.start();
+        bool result = QApplication::notify(receiver, event);
+        times->samples.push_back(timer.nsecsElapsed());
+        return result;
+    }
+
+    DealScheduler *scheduler = nullptr; ///< The scheduler whose deal ticks are measured.
+    EventTimes ticks; ///< The deal ticks of the countdown timer.
+    EventTimes paints; ///< The paint events of all widgets.
+    EventTimes layouts; ///< The layout passes of all widgets.
+};
+
+/**
+ * @brief Drives a table with N active table slots on the offscreen platform at maximum deal speed.
+ *
+ * Jokers are answered automatically on the next event loop iteration and the run stops after the given
+ * number of ticks or when every shoe is finished. Run one process per slot count, since the peak RSS only
+ * grows: for n in 1 10 50 100 500; do stress-bench --slots $n; done
+ */
+int main(int argc, char *argv[]) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    BenchApplication app(argc, argv);
+    KLocalizedString::setApplicationDomain("card-counter");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({"slots", "Number of active table slots (1-500).", "count", "10"});
+    parser.addOption({"ticks", "Number of deal ticks to run.", "count", "500"});
+    parser.addOption({"decks", "Number of card decks per table slot (1-10).", "count", "10"});
+    parser.addOption({"level", "Difficulty level: easy, medium, hard or nightmare.", "name", "easy"});
+    parser.addOption({"header", "Print the CSV header line."});
+    parser.process(app);
+
+    const qint32 slotCount = qBound(1, parser.value("slots").toInt(), 500);
+    const qint32 tickLimit = qMax(1, parser.value("ticks").toInt());
+    const qint32 decks = qBound(1, parser.value("decks").toInt(), 10);
+
+    // the same levels as MainWindow::setupActions
+    Kg::difficulty()->addStandardLevelRange(
+            KgDifficultyLevel::Easy, KgDifficultyLevel::Hard, KgDifficultyLevel::Easy
+    );
+    Kg::difficulty()->addLevel(new KgDifficultyLevel(1000,
+                                                     QByteArray("Nightmare"), QStringLiteral("Nightmare")
+    ));
+    for (const auto *level: Kg::difficulty()->levels()) {
+        if (QString(level->key()).compare(parser.value("level"), Qt::CaseInsensitive) == 0) {
+            Kg::difficulty()->select(level);
+        }
+    }
+
+    auto *table = new Table();
+    table->resize(1920, 1080);
+    table->show();
+    table->createNewGame(Kg::difficultyLevel());
+    QApplication::processEvents();
+
+    QElapsedTimer setupTimer;
+    setupTimer.start();
+    auto isActive = [](TableSlot *tableSlot) { return !tableSlot->isFake(); };
+    QVector<TableSlot *> tableSlots = table->getTableSlots();
+    while (std::count_if(tableSlots.begin(), tableSlots.end(), isActive) < slotCount) {
+        tableSlots.last()->setDeckCount(decks);
+        tableSlots = table->getTableSlots();
+    }
+    for (auto *tableSlot: tableSlots) {
+        if (!tableSlot->isFake()) {
+            tableSlot->setDeckCount(decks);
+        }
+    }
+    QApplication::processEvents();
+    const qint64 setupNsecs = setupTimer.nsecsElapsed();
+
+    for (auto *tableSlot: tableSlots) {
+        QObject::connect(tableSlot, &TableSlot::userQuizzed, tableSlot, [tableSlot]() {
+            QTimer::singleShot(0, tableSlot, &TableSlot::userChecking);
+        });
+    }
+
+    app.paints.samples.clear();
+    app.layouts.samples.clear();
+    app.scheduler = table->getDealScheduler();
+
+    QElapsedTimer runTimer;
+    runTimer.start();
+    table->setDealInterval(0);
+    table->pause(false);
+    QObject::connect(table, &Table::gameOver, &app, &QApplication::quit);
+    auto *watchdog = new QTimer(&app);
+    QObject::connect(watchdog, &QTimer::timeout, &app, [&app, tickLimit]() {
+        if (app.ticks.samples.size() >= tickLimit) {
+            QApplication::quit();
+        }
+    });
+    watchdog->start(10);
+    QApplication::exec();
+    const qint64 runNsecs = runTimer.nsecsElapsed();
+    table->pause(true);
+    app.scheduler = nullptr;
+    const DealScheduler::Jitter jitter = table->getDealScheduler()->getJitter();
+
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    QTextStream out(stdout);
+    if (parser.isSet("header")) {
+        out << "slots,decks,setup_ms,ticks,ticks_per_s,tick_p50_us,tick_p90_us,tick_p99_us,tick_max_us,"
+               "paints,paint_total_ms,paint_p99_us,layouts,layout_total_ms,layout_p99_us,"
+               "jitter_mean_us,jitter_stddev_us,jitter_max_us,peak_rss_kb\n";
+    }
+    const qint32 tickCount = app.ticks.samples.size();
+    out << slotCount << ',' << decks << ','
+        << setupNsecs / 1000000.0 << ','
+        << tickCount << ','
+        << tickCount * 1e9 / qMax(runNsecs, qint64(1)) << ','
+        << app.ticks.percentile(0.5) / 1000 << ','
+        << app.ticks.percentile(0.9) / 1000 << ','
+        << app.ticks.percentile(0.99) / 1000 << ','
+        << app.ticks.percentile(1.0) / 1000 << ','
+        << app.paints.samples.size() << ','
+        << app.paints.total() / 1000000.0 << ','
+        << app.paints.percentile(0.99) / 1000 << ','
+        << app.layouts.samples.size() << ','
+        << app.layouts.total() / 1000000.0 << ','
+        << app.layouts.percentile(0.99) / 1000 << ','
+        << jitter.mean / 1000 << ','
+        << jitter.stddev() / 1000 << ','
+        << jitter.max / 1000 << ','
+        << usage.ru_maxrss << '\n';
+
+    delete table;
+    return 0;
+}
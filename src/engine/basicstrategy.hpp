@@ -0,0 +1,130 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_BASICSTRATEGY_HPP
+#define CARD_COUNTER_BASICSTRATEGY_HPP
+
+// Qt
+#include <QtGlobal>
+
+/**
+ * @brief The basic strategy for multiple decks, dealer stands on soft 17, double after split allowed.
+ *
+ * Rows are the player's total (or the value of a pair's card), columns the dealer's upcard 2 to 10 and ace.
+ * The same charts are used for H17 tables, where they differ in a handful of rare hands.
+ */
+namespace BasicStrategy {
+    /**
+     * @brief The decisions of the charts.
+     */
+    enum Action : char {
+        Hit = 'H', /**< Take a card. */
+        Stand = 'S', /**< Take no more cards. */
+        Double = 'D', /**< Double if allowed, hit otherwise. */
+        DoubleOrStand = 'd', /**< Double if allowed, stand otherwise. */
+        Split = 'P', /**< Split the pair. */
+        SplitIfDouble = 'p', /**< Split if doubling after the split is allowed, play the total otherwise. */
+        PlayTotal = '-' /**< Do not split, play the total. */
+    };
+
+    /// Hard totals 0 to 21.
+    constexpr char hard[22][11] = {
+            "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH",
+            "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", // 0 - 8
+            "HDDDDHHHHH", // 9
+            "DDDDDDDDHH", // 10
+            "DDDDDDDDDH", // 11
+            "HHSSSHHHHH", // 12
+            "SSSSSHHHHH", "SSSSSHHHHH", "SSSSSHHHHH", "SSSSSHHHHH", // 13 - 16
+            "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS" // 17 - 21
+    };
+
+    /// Soft totals 0 to 21, only 12 to 21 occur.
+    constexpr char soft[22][11] = {
+            "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH",
+            "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH", "HHHHHHHHHH",
+            "HHHHHHHHHH", // 12
+            "HHHDDHHHHH", "HHHDDHHHHH", // 13 - 14
+            "HHDDDHHHHH", "HHDDDHHHHH", // 15 - 16
+            "HDDDDHHHHH", // 17
+            "SddddSSHHH", // 18
+            "SSSSSSSSSS", "SSSSSSSSSS", "SSSSSSSSSS" // 19 - 21
+    };
+
+    /// Pairs by the value of their cards, 1 for aces to 10; row 0 is unused.
+    constexpr char pairs[11][11] = {
+            "----------",
+            "PPPPPPPPPP", // A
+            "ppPPPP----", // 2
+            "ppPPPP----", // 3
+            "---pp-----", // 4
+            "----------", // 5
+            "pPPPP-----", // 6
+            "PPPPPP----", // 7
+            "PPPPPPPPPP", // 8
+            "PPPPP-PP--", // 9
+            "----------" // 10
+    };
+
+    /**
+     * @brief Returns the column of a dealer's upcard.
+     * @param upcard The value of the upcard, 1 for an ace to 10.
+     * @return The column, 0 for a two to 9 for an ace.
+     */
+    constexpr qint32 column(qint32 upcard) {
+        return upcard == 1 ? 9 : upcard - 2;
+    }
+
+    /**
+     * @brief Looks up the decision for a hand.
+     * @param total The hard total, counting aces as one.
+     * @param soft Whether an ace can count as eleven without busting.
+     * @param pair The value of the cards if the hand can be split, 0 otherwise.
+     * @param upcard The value of the dealer's upcard, 1 for an ace to 10.
+     * @param canDouble Whether the hand may be doubled.
+     * @param doubleAfterSplit Whether the rules allow doubling after a split.
+     * @return Hit, Stand, Double or Split.
+     */
+    constexpr Action decide(qint32 total, bool soft, qint32 pair, qint32 upcard, bool canDouble,
+                            bool doubleAfterSplit) {
+        const qint32 col = column(upcard);
+        if (pair) {
+            const char split = pairs[pair][col];
+            if (split == Split || (split == SplitIfDouble && doubleAfterSplit)) {
+                return Split;
+            }
+        }
+        const char action = soft ? BasicStrategy::soft[total + 10][col] : hard[total][col];
+        if (action == Double) {
+            return canDouble ? Double : Hit;
+        }
+        if (action == DoubleOrStand) {
+            return canDouble ? Double : Stand;
+        }
+        return Action(action);
+    }
+
+    static_assert(decide(16, false, 0, 10, true, true) == Hit, "16 hits against a ten");
+    static_assert(decide(11, false, 0, 6, true, true) == Double, "11 doubles against a six");
+    static_assert(decide(8, true, 0, 3, false, true) == Stand, "soft 18 stands if it cannot double");
+    static_assert(decide(16, false, 8, 1, true, true) == Split, "eights are always split");
+}
+
+#endif //CARD_COUNTER_BASICSTRATEGY_HPP
@@ -0,0 +1,312 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <numeric>
+#include <random>
+// Qt
+#include <QtConcurrent>
+#include <QtMath>
+// own
+#include "blackjackengine.hpp"
+#include "dealeroutcomes.hpp"
+#include "src/strategy/weightmatrix.hpp"
+#include "src/widgets/cards.hpp"
+
+namespace {
+    /// The most hands a round can be split into.
+    constexpr qint32 handLimit = 8;
+    /// The number of shoes played from one random generator in simulate().
+    constexpr qint64 chunkSize = 16;
+}
+
+constexpr qint32 BlackjackEngine::minTrueCount;
+constexpr qint32 BlackjackEngine::maxTrueCount;
+constexpr qint32 BlackjackEngine::bucketCount;
+
+double BlackjackEngine::Bucket::ev() const {
+    return rounds ? total / rounds : 0;
+}
+
+double BlackjackEngine::Bucket::standardError() const {
+    if (rounds < 2) {
+        return 0;
+    }
+    const double mean = ev();
+    return qSqrt(qMax(0.0, squares / rounds - mean * mean) / (rounds - 1));
+}
+
+void BlackjackEngine::Bucket::merge(const Bucket &other) {
+    rounds += other.rounds;
+    total += other.total;
+    squares += other.squares;
+}
+
+const BlackjackEngine::Bucket &BlackjackEngine::Result::bucket(qint32 strategy, qint32 trueCount) const {
+    return buckets[strategy * bucketCount + qBound(minTrueCount, trueCount, maxTrueCount) - minTrueCount];
+}
+
+void BlackjackEngine::Result::merge(const Result &other) {
+    for (qint32 i = 0; i < buckets.size(); i++) {
+        buckets[i].merge(other.buckets[i]);
+    }
+    shoes += other.shoes;
+    rounds += other.rounds;
+    hands += other.hands;
+}
+
+void BlackjackEngine::Hand::add(qint32 card) {
+    if (!cards) {
+        first = card;
+    }
+    last = card;
+    total += card;
+    ace |= card == 1;
+    cards++;
+}
+
+bool BlackjackEngine::Hand::soft() const {
+    return ace && total + 10 <= 21;
+}
+
+qint32 BlackjackEngine::Hand::best() const {
+    return soft() ? total + 10 : total;
+}
+
+BlackjackEngine::BlackjackEngine(const Rules &rules, const WeightMatrix &weights, qint32 deckCount, quint64 seed)
+        : rules(rules), weights(weights), deckCount(deckCount) {
+    std::seed_seq sequence{quint32(seed), quint32(seed >> 32), quint32(deckCount)};
+    generator.seed(sequence);
+    counts.fill(0, weights.strategyCount());
+    trueCounts.fill(0, weights.strategyCount());
+    result.strategyCount = weights.strategyCount();
+    result.buckets.resize(weights.strategyCount() * bucketCount);
+}
+
+BlackjackEngine::Result BlackjackEngine::play(qint64 shoes) {
+    const qint64 target = result.shoes + shoes;
+    shuffle();
+    for (;;) {
+        if (position >= reshuffleAt || cutCard) {
+            if (result.shoes >= target) {
+                break;
+            }
+            shuffle();
+        }
+        bucketize();
+        const double outcome = playRound();
+        result.rounds++;
+        Bucket *buckets = result.buckets.data();
+        for (qint32 k = 0; k < result.strategyCount; k++) {
+            Bucket &bucket = buckets[k * bucketCount + trueCounts[k]];
+            bucket.rounds++;
+            bucket.total += outcome;
+            bucket.squares += outcome * outcome;
+        }
+    }
+    return result;
+}
+
+BlackjackEngine::Result BlackjackEngine::simulate(const Rules &rules, const WeightMatrix &weights, qint32 deckCount,
+                                                  qint64 shoes, quint64 seed) {
+    QVector<qint64> chunks((shoes + chunkSize - 1) / chunkSize);
+    std::iota(chunks.begin(), chunks.end(), 0);
+    QVector<Result> partial(chunks.size());
+    Result *out = partial.data();
+    QtConcurrent::blockingMap(chunks, [&, out](qint64 chunk) {
+        BlackjackEngine engine(rules, weights, deckCount, seed + 0x9e3779b97f4a7c15ULL * quint64(chunk + 1));
+        out[chunk] = engine.play(qMin(chunkSize, shoes - chunk * chunkSize));
+    });
+
+    // merged in chunk order, so the sums do not depend on the scheduling
+    Result result;
+    result.strategyCount = weights.strategyCount();
+    result.buckets.resize(weights.strategyCount() * bucketCount);
+    for (const Result &chunk: qAsConst(partial)) {
+        result.merge(chunk);
+    }
+    return result;
+}
+
+void BlackjackEngine::shuffle() {
+    const QList<qint32> cards = Cards::shuffleCards(deckCount, generator);
+    shoe.resize(cards.size());
+    for (qint32 i = 0; i < cards.size(); i++) {
+        shoe[i] = quint8(Cards::getRank(cards[i]));
+    }
+    position = 0;
+    reshuffleAt = qBound(1, qint32(rules.penetration * shoe.size()), shoe.size());
+    cutCard = false;
+    counts.fill(0);
+    result.shoes++;
+}
+
+qint32 BlackjackEngine::draw() {
+    for (;;) {
+        if (position == shoe.size()) {
+            // a long round can run out of cards, it goes on with a fresh shoe
+            shuffle();
+        }
+        const qint32 rank = shoe[position++];
+        if (rank) {
+            const qint32 *column = weights.column(rank);
+            qint32 *count = counts.data();
+            for (qint32 k = 0; k < result.strategyCount; k++) {
+                count[k] += column[k];
+            }
+            return value(rank);
+        }
+        if (rules.jokers == Rules::CutCard) {
+            cutCard = true;
+        }
+    }
+}
+
+void BlackjackEngine::bucketize() {
+    // the true count is the running count per remaining deck of 54 cards, rounded down
+    const qint32 remaining = shoe.size() - position;
+    for (qint32 k = 0; k < result.strategyCount; k++) {
+        const qint32 scaled = counts[k] * 54;
+        qint32 trueCount = 0;
+        if (remaining) {
+            trueCount = scaled >= 0 ? scaled / remaining : -((remaining - 1 - scaled) / remaining);
+        }
+        trueCounts[k] = qBound(minTrueCount, trueCount, maxTrueCount) - minTrueCount;
+    }
+}
+
+double BlackjackEngine::playRound() {
+    Hand player;
+    Hand dealer;
+    player.add(draw());
+    dealer.add(draw());
+    player.add(draw());
+    dealer.add(draw());
+
+    // the dealer peeks, so a dealer natural only costs the initial bet
+    if (dealer.best() == 21) {
+        result.hands++;
+        return player.best() == 21 ? 0 : -1;
+    }
+    if (player.best() == 21) {
+        result.hands++;
+        return rules.blackjackPays;
+    }
+
+    return playHands(player, dealer);
+}
+
+double BlackjackEngine::playHands(const Hand &player, Hand dealer, const BasicStrategy::Action *forced) {
+    const qint32 upcard = dealer.first;
+    const qint32 maxHands = qBound(1, rules.maxHands, handLimit);
+    Hand hands[handLimit];
+    hands[0] = player;
+    qint32 handCount = 1;
+    for (qint32 i = 0; i < handCount; i++) {
+        Hand &hand = hands[i];
+        if (hand.cards == 1) {
+            // the second card of a split hand
+            hand.add(draw());
+        }
+        while (hand.best() < 21) {
+            const bool splitAces = hand.split && hand.first == 1;
+            const bool canSplit = hand.cards == 2 && hand.first == hand.last && handCount < maxHands
+                                  && (!splitAces || rules.resplitAces);
+            if (splitAces && !canSplit) {
+                break; // split aces get one card only
+            }
+            const bool canDouble = hand.cards == 2 && (!hand.split || rules.doubleAfterSplit);
+            const BasicStrategy::Action action = forced ? *forced
+                                                        : BasicStrategy::decide(hand.total, hand.soft(),
+                                                                                canSplit ? hand.first : 0, upcard,
+                                                                                canDouble, rules.doubleAfterSplit);
+            forced = nullptr;
+            if (action == BasicStrategy::Split) {
+                const qint32 card = hand.first;
+                Hand &other = hands[handCount++];
+                other = Hand();
+                other.split = true;
+                other.add(card);
+                hand = Hand();
+                hand.split = true;
+                hand.add(card);
+                hand.add(draw());
+            } else if (action == BasicStrategy::Double) {
+                hand.bet *= 2;
+                hand.add(draw());
+                break;
+            } else if (action == BasicStrategy::Hit) {
+                hand.add(draw());
+            } else {
+                break;
+            }
+        }
+    }
+    result.hands += handCount;
+
+    bool live = false;
+    for (qint32 i = 0; i < handCount; i++) {
+        live |= hands[i].best() <= 21;
+    }
+    if (live && dealerOutcomes) {
+        // the hole card is unknown to the player, it goes back into the cards the dealer's hand is drawn from
+        QVector<qint32> composition(13, 0);
+        for (qint32 i = position; i < shoe.size(); i++) {
+            if (shoe[i]) {
+                composition[shoe[i] - 1]++;
+            }
+        }
+        composition[dealer.last - 1]++;
+        const DealerOutcomes::Outcome results = dealerOutcomes->compute(composition, upcard, true);
+        double outcome = 0;
+        for (qint32 i = 0; i < handCount; i++) {
+            const qint32 total = hands[i].best();
+            if (total > 21) {
+                outcome -= hands[i].bet;
+                continue;
+            }
+            double balance = results.probability(DealerOutcomes::Bust);
+            for (qint32 dealerTotal = 17; dealerTotal <= 21; dealerTotal++) {
+                const double p = results.probabilities[DealerOutcomes::Seventeen + dealerTotal - 17];
+                balance += total > dealerTotal ? p : total < dealerTotal ? -p : 0;
+            }
+            outcome += hands[i].bet * balance;
+        }
+        return outcome;
+    }
+    const qint32 dealerTotal = live ? playDealer(dealer) : dealer.best();
+    double outcome = 0;
+    for (qint32 i = 0; i < handCount; i++) {
+        const qint32 total = hands[i].best();
+        if (total > 21 || (dealerTotal <= 21 && total < dealerTotal)) {
+            outcome -= hands[i].bet;
+        } else if (dealerTotal > 21 || total > dealerTotal) {
+            outcome += hands[i].bet;
+        }
+    }
+    return outcome;
+}
+
+qint32 BlackjackEngine::playDealer(Hand hand) {
+    while (hand.best() < 17 || (rules.dealerHitsSoft17 && hand.best() == 17 && hand.soft())) {
+        hand.add(draw());
+    }
+    return hand.best();
+}
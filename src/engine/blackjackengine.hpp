@@ -0,0 +1,224 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_BLACKJACKENGINE_HPP
+#define CARD_COUNTER_BLACKJACKENGINE_HPP
+
+// Qt
+#include <QRandomGenerator>
+#include <QVector>
+// own
+#include "rules.hpp"
+#include "basicstrategy.hpp"
+
+class WeightMatrix;
+
+class DealerOutcomes;
+
+/**
+ * @brief The BlackjackEngine class plays blackjack rounds with basic strategy from shuffled shoes and measures
+ * the player's return per true count of every strategy of a WeightMatrix.
+ *
+ * The shoes come from Cards::shuffleCards, the jokers are handled as the rules say. Since basic strategy does
+ * not depend on the count, every round is played once and booked into the true count bucket of every strategy
+ * at its start. The dealer peeks for blackjack, a natural pays Rules::blackjackPays, insurance is never taken.
+ */
+class BlackjackEngine {
+public:
+    static constexpr qint32 minTrueCount = -10; ///< The lowest bucket, smaller true counts are booked there.
+    static constexpr qint32 maxTrueCount = 10; ///< The highest bucket, larger true counts are booked there.
+    static constexpr qint32 bucketCount = maxTrueCount - minTrueCount + 1; ///< The number of buckets.
+
+    /**
+     * @brief The returns of the rounds starting at one true count.
+     */
+    struct Bucket {
+        qint64 rounds = 0; ///< The number of rounds.
+        double total = 0; ///< The sum of the returns, in initial bets.
+        double squares = 0; ///< The sum of the squared returns.
+
+        /**
+         * @brief Returns the expected value per round.
+         * @return The mean return in initial bets.
+         */
+        double ev() const;
+
+        /**
+         * @brief Returns the standard error of ev().
+         * @return The standard error in initial bets.
+         */
+        double standardError() const;
+
+        /**
+         * @brief Adds the rounds of another bucket.
+         * @param other The bucket to add.
+         */
+        void merge(const Bucket &other);
+    };
+
+    /**
+     * @brief The results of a simulation.
+     */
+    struct Result {
+        qint32 strategyCount = 0; ///< The number of strategies.
+        QVector<Bucket> buckets; ///< bucketCount buckets per strategy, strategy-major.
+        qint64 shoes = 0; ///< The number of dealt shoes.
+        qint64 rounds = 0; ///< The number of played rounds.
+        qint64 hands = 0; ///< The number of played player hands, including split hands.
+
+        /**
+         * @brief Returns the bucket of a strategy and true count.
+         * @param strategy The row of the strategy in the weight matrix.
+         * @param trueCount The true count, minTrueCount to maxTrueCount.
+         * @return The bucket.
+         */
+        const Bucket &bucket(qint32 strategy, qint32 trueCount) const;
+
+        /**
+         * @brief Adds the rounds of another result with the same strategies.
+         * @param other The result to add.
+         */
+        void merge(const Result &other);
+    };
+
+    /**
+     * @brief Constructs an engine.
+     * @param rules The table rules.
+     * @param weights The strategies whose true counts the rounds are booked by.
+     * @param deckCount The number of decks per shoe, 1 to 10.
+     * @param seed The seed of the shoes.
+     */
+    BlackjackEngine(const Rules &rules, const WeightMatrix &weights, qint32 deckCount, quint64 seed);
+
+    /**
+     * @brief Plays all rounds of the given number of shoes.
+     * @param shoes The number of shoes.
+     * @return The returns per strategy and true count.
+     */
+    Result play(qint64 shoes);
+
+    /**
+     * @brief Plays shoes in parallel chunks on the global thread pool, reproducible for a seed.
+     * @param rules The table rules.
+     * @param weights The strategies whose true counts the rounds are booked by.
+     * @param deckCount The number of decks per shoe, 1 to 10.
+     * @param shoes The number of shoes.
+     * @param seed The seed of the run.
+     * @return The returns per strategy and true count.
+     */
+    static Result simulate(const Rules &rules, const WeightMatrix &weights, qint32 deckCount, qint64 shoes,
+                           quint64 seed);
+
+    /**
+     * @brief Returns the blackjack value of a rank.
+     * @param rank The rank, Cards::Rank::Ace to Cards::Rank::King.
+     * @return 1 for an ace, 2 to 9, or 10.
+     */
+    static constexpr qint32 value(qint32 rank) {
+        return rank >= 10 ? 10 : rank;
+    }
+
+protected:
+    /**
+     * @brief A player's hand.
+     */
+    struct Hand {
+        qint32 total = 0; ///< The total with aces counted as one.
+        qint32 cards = 0; ///< The number of cards.
+        qint32 first = 0; ///< The value of the first card.
+        qint32 last = 0; ///< The value of the last card.
+        bool ace = false; ///< Whether the hand holds an ace.
+        bool split = false; ///< Whether the hand comes from a split.
+        double bet = 1; ///< The bet on the hand.
+
+        /**
+         * @brief Adds a card to the hand.
+         * @param card The blackjack value of the card.
+         */
+        void add(qint32 card);
+
+        /**
+         * @brief Checks whether an ace counts as eleven.
+         * @return True if the total is soft, false otherwise.
+         */
+        bool soft() const;
+
+        /**
+         * @brief Returns the total with an ace counted as eleven if that does not bust.
+         * @return The total.
+         */
+        qint32 best() const;
+    };
+
+    /**
+     * @brief Shuffles a new shoe and resets the running counts.
+     */
+    void shuffle();
+
+    /**
+     * @brief Deals the next card, counting it with every strategy and handling jokers.
+     * @return The blackjack value of the card.
+     */
+    qint32 draw();
+
+    /**
+     * @brief Computes the true count buckets of all strategies at the current position.
+     */
+    void bucketize();
+
+    /**
+     * @brief Plays one round.
+     * @return The return in initial bets.
+     */
+    double playRound();
+
+    /**
+     * @brief Plays the player's hands of a dealt round in which neither side has a natural, then the dealer's.
+     * With dealerOutcomes set, the hands are settled against the exact results of the dealer from the remaining
+     * cards instead of one dealt dealer hand.
+     * @param player The player's two cards.
+     * @param dealer The dealer's upcard and hole card.
+     * @param forced The first decision on the player's hand instead of basic strategy, or nullptr.
+     * @return The return in initial bets.
+     */
+    double playHands(const Hand &player, Hand dealer, const BasicStrategy::Action *forced = nullptr);
+
+    /**
+     * @brief Plays the dealer's hand.
+     * @param hand The upcard and hole card.
+     * @return The final total, over 21 if busted.
+     */
+    qint32 playDealer(Hand hand);
+
+    Rules rules; ///< The table rules.
+    const WeightMatrix &weights; ///< The strategies the running counts are kept for.
+    qint32 deckCount; ///< The number of decks per shoe.
+    QRandomGenerator generator; ///< The source of the shoes.
+    QVector<quint8> shoe; ///< The ranks of the current shoe, 0 for jokers.
+    qint32 position = 0; ///< The number of cards dealt from the shoe.
+    qint32 reshuffleAt = 0; ///< The position from which the next round reshuffles.
+    bool cutCard = false; ///< Whether a joker asked for a reshuffle after the round.
+    QVector<qint32> counts; ///< The running count of every strategy.
+    QVector<qint32> trueCounts; ///< The true count bucket of every strategy at the start of the round.
+    Result result; ///< The returns of the played rounds.
+    DealerOutcomes *dealerOutcomes = nullptr; ///< The dealer's exact results to settle with, or nullptr to deal.
+};
+
+#endif //CARD_COUNTER_BLACKJACKENGINE_HPP
@@ -0,0 +1,220 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <algorithm>
+#include <iterator>
+// own
+#include "dealeroutcomes.hpp"
+
+namespace {
+    // the kinds of memoized nodes, in the top bits of Slot::hand
+    const quint32 handNode = 0;
+    const quint32 upcardNode = 1u << 8;
+    const quint32 peekedNode = 2u << 8;
+}
+
+const qint32 DealerOutcomes::shifts[11] = {0, 0, 6, 12, 18, 24, 30, 36, 42, 48, 54};
+
+double DealerOutcomes::Stats::hitRate() const {
+    return lookups ? double(hits) / double(lookups) : 0;
+}
+
+DealerOutcomes::DealerOutcomes(const Rules &rules, qint64 memoryBudget)
+        : hitsSoft17(rules.dealerHitsSoft17) {
+    qint64 size = 1;
+    while (2 * size * qint64(sizeof(Slot)) <= memoryBudget) {
+        size *= 2;
+    }
+    if (size * qint64(sizeof(Slot)) <= memoryBudget) {
+        slots.resize(qint32(size));
+        mask = quint64(size - 1);
+    }
+}
+
+DealerOutcomes::Outcome DealerOutcomes::compute(const QVector<qint32> &composition, qint32 upcard, bool peeked) {
+    load(composition);
+    return start(upcard, peeked);
+}
+
+DealerOutcomes::Outcome DealerOutcomes::computeUncached(const Rules &rules, const QVector<qint32> &composition,
+                                                        qint32 upcard, bool peeked) {
+    DealerOutcomes outcomes(rules, 0);
+    return outcomes.compute(composition, upcard, peeked);
+}
+
+QVector<qint32> DealerOutcomes::fullShoe(qint32 deckCount) {
+    return QVector<qint32>(13, 4 * deckCount);
+}
+
+DealerOutcomes::Stats DealerOutcomes::stats() const {
+    Stats stats;
+    stats.lookups = lookups;
+    stats.hits = hits;
+    stats.insertions = insertions;
+    stats.evictions = evictions;
+    stats.entries = entries;
+    stats.bytes = slots.size() * qint64(sizeof(Slot));
+    return stats;
+}
+
+void DealerOutcomes::clear() {
+    slots.fill(Slot());
+    entries = 0;
+    evictions = 0;
+    lookups = 0;
+    hits = 0;
+    insertions = 0;
+}
+
+void DealerOutcomes::load(const QVector<qint32> &composition) {
+    std::fill(std::begin(counts), std::end(counts), 0);
+    for (qint32 rank = 0; rank < composition.size() && rank < 13; rank++) {
+        counts[qMin(rank + 1, 10)] += composition[rank];
+    }
+    remaining = 0;
+    packed = 0;
+    for (qint32 value = 1; value <= 10; value++) {
+        // the packing holds the cards of 10 decks, 40 per value and 160 tens
+        counts[value] = qBound(0, counts[value], value == 10 ? 255 : 63);
+        remaining += counts[value];
+        packed |= quint64(counts[value]) << shifts[value];
+    }
+}
+
+DealerOutcomes::Outcome DealerOutcomes::start(qint32 upcard, bool peeked) {
+    const quint32 hand = (peeked ? peekedNode : upcardNode) | quint32(upcard);
+    Outcome outcome;
+    if (find(hand, outcome)) {
+        return outcome;
+    }
+    // the hole card that would make a natural, ruled out if the dealer peeked
+    const qint32 natural = upcard == 1 ? 10 : upcard == 10 ? 1 : 0;
+    const qint32 cards = remaining - (peeked && natural ? counts[natural] : 0);
+    if (cards <= 0) {
+        return outcome;
+    }
+    for (qint32 value = 1; value <= 10; value++) {
+        if (!counts[value] || (peeked && value == natural)) {
+            continue;
+        }
+        const double p = double(counts[value]) / cards;
+        if (value == natural) {
+            outcome.probabilities[Natural] += p;
+            continue;
+        }
+        counts[value]--;
+        remaining--;
+        packed -= quint64(1) << shifts[value];
+        const Outcome next = play(upcard + value, upcard == 1 || value == 1);
+        counts[value]++;
+        remaining++;
+        packed += quint64(1) << shifts[value];
+        for (qint32 i = 0; i < TotalCount; i++) {
+            outcome.probabilities[i] += p * next.probabilities[i];
+        }
+    }
+    store(hand, outcome);
+    return outcome;
+}
+
+DealerOutcomes::Outcome DealerOutcomes::play(qint32 total, bool ace) {
+    Outcome outcome;
+    const bool soft = ace && total + 10 <= 21;
+    const qint32 best = soft ? total + 10 : total;
+    if (best > 21) {
+        outcome.probabilities[Bust] = 1;
+        return outcome;
+    }
+    if (best >= 17 && !(best == 17 && soft && hitsSoft17)) {
+        outcome.probabilities[Seventeen + best - 17] = 1;
+        return outcome;
+    }
+    if (!remaining) {
+        // an exhausted shoe is not reshuffled here, the dealer is treated as busted
+        outcome.probabilities[Bust] = 1;
+        return outcome;
+    }
+
+    const quint32 hand = handNode | quint32(total) | (ace ? 0x80u : 0u);
+    const bool memoized = total <= memoizedTotal;
+    if (memoized && find(hand, outcome)) {
+        return outcome;
+    }
+    for (qint32 value = 1; value <= 10; value++) {
+        if (!counts[value]) {
+            continue;
+        }
+        const double p = double(counts[value]) / remaining;
+        counts[value]--;
+        remaining--;
+        packed -= quint64(1) << shifts[value];
+        const Outcome next = play(total + value, ace || value == 1);
+        counts[value]++;
+        remaining++;
+        packed += quint64(1) << shifts[value];
+        for (qint32 i = 0; i < TotalCount; i++) {
+            outcome.probabilities[i] += p * next.probabilities[i];
+        }
+    }
+    if (memoized) {
+        store(hand, outcome);
+    }
+    return outcome;
+}
+
+DealerOutcomes::Slot &DealerOutcomes::slot(quint32 hand) {
+    // the finalizer of MurmurHash3 spreads the small differences between neighbouring compositions
+    quint64 hash = packed * 31 + hand;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return slots[qint32(hash & mask)];
+}
+
+bool DealerOutcomes::find(quint32 hand, Outcome &outcome) {
+    if (slots.isEmpty()) {
+        return false;
+    }
+    lookups++;
+    const Slot &entry = slot(hand);
+    if (entry.hand != hand || entry.counts != packed) {
+        return false;
+    }
+    hits++;
+    outcome = entry.outcome;
+    return true;
+}
+
+void DealerOutcomes::store(quint32 hand, const Outcome &outcome) {
+    if (slots.isEmpty()) {
+        return;
+    }
+    insertions++;
+    Slot &entry = slot(hand);
+    if (entry.hand) {
+        evictions++;
+    } else {
+        entries++;
+    }
+    entry.counts = packed;
+    entry.hand = hand;
+    entry.outcome = outcome;
+}
@@ -0,0 +1,207 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_DEALEROUTCOMES_HPP
+#define CARD_COUNTER_DEALEROUTCOMES_HPP
+
+// Qt
+#include <QVector>
+// own
+#include "rules.hpp"
+
+/**
+ * @brief The DealerOutcomes class computes the exact probabilities of the dealer's final totals for the
+ * remaining composition of a shoe.
+ *
+ * The dealer's play only depends on the card values, so the 13 rank counts are merged into 10 value counts
+ * and packed into one 64 bit word, 6 bits for every value from ace to nine and 8 bits for the tens. The nodes
+ * of the drawing recursion are memoized under that word and the dealer's hand, so all compositions that only
+ * differ in which ten-valued ranks are left share their entries, the orders of the same drawn cards meet in
+ * one entry, and repeated questions about a composition are answered from the cache. The entries live in a
+ * direct-mapped table allocated once within the memory budget, where a colliding node replaces the older one.
+ * Hands above a hard 14 end after a card or two and are recomputed rather than stored. An instance is not
+ * thread-safe; every thread of a simulation uses its own one.
+ */
+class DealerOutcomes {
+public:
+    /**
+     * @brief The final result of the dealer's hand.
+     */
+    enum Total {
+        Seventeen = 0, /**< The dealer stands on 17. */
+        Eighteen, /**< The dealer stands on 18. */
+        Nineteen, /**< The dealer stands on 19. */
+        Twenty, /**< The dealer stands on 20. */
+        TwentyOne, /**< The dealer stands on 21 with three or more cards. */
+        Natural, /**< The dealer has a natural blackjack. */
+        Bust, /**< The dealer busts. */
+        TotalCount /**< The number of results. */
+    };
+
+    /**
+     * @brief The probabilities of all results.
+     */
+    struct Outcome {
+        double probabilities[TotalCount] = {}; ///< The probability of every result, summing up to 1.
+
+        /**
+         * @brief Returns the probability of a result.
+         * @param total The result.
+         * @return The probability in [0, 1].
+         */
+        double probability(Total total) const {
+            return probabilities[total];
+        }
+    };
+
+    /**
+     * @brief The usage of the cache since the construction or the last clear().
+     */
+    struct Stats {
+        qint64 lookups = 0; ///< The number of memoized nodes looked up.
+        qint64 hits = 0; ///< The number of lookups found in the cache.
+        qint64 insertions = 0; ///< The number of computed nodes stored.
+        qint64 evictions = 0; ///< The number of stored nodes replaced by a colliding one.
+        qint32 entries = 0; ///< The number of nodes in the cache.
+        qint64 bytes = 0; ///< The memory of the table.
+
+        /**
+         * @brief Returns the fraction of lookups found in the cache.
+         * @return The hit rate in [0, 1].
+         */
+        double hitRate() const;
+    };
+
+    /**
+     * @brief Constructs an empty cache.
+     * @param rules The table rules, only the soft 17 rule matters.
+     * @param memoryBudget The largest memory of the table in bytes.
+     */
+    explicit DealerOutcomes(const Rules &rules, qint64 memoryBudget = 4 << 20);
+
+    /**
+     * @brief Computes the dealer's results for an upcard, looking every node up in the cache first.
+     * @param composition The number of remaining cards of every rank from ace to king, without the upcard.
+     * @param upcard The value of the dealer's upcard, 1 for an ace.
+     * @param peeked Whether the dealer already checked the hole card for a natural and has none.
+     * @return The probabilities.
+     */
+    Outcome compute(const QVector<qint32> &composition, qint32 upcard, bool peeked = false);
+
+    /**
+     * @brief Computes the dealer's results for an upcard by the plain recursion, without any cache.
+     * @param rules The table rules, only the soft 17 rule matters.
+     * @param composition The number of remaining cards of every rank from ace to king, without the upcard.
+     * @param upcard The value of the dealer's upcard, 1 for an ace.
+     * @param peeked Whether the dealer already checked the hole card for a natural and has none.
+     * @return The probabilities.
+     */
+    static Outcome computeUncached(const Rules &rules, const QVector<qint32> &composition, qint32 upcard,
+                                   bool peeked = false);
+
+    /**
+     * @brief Returns the composition of a number of full decks of 52 cards, the jokers left out.
+     * @param deckCount The number of decks.
+     * @return The number of cards of every rank from ace to king.
+     */
+    static QVector<qint32> fullShoe(qint32 deckCount);
+
+    /**
+     * @brief Returns the usage of the cache.
+     * @return The statistics.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Drops all entries and resets the statistics.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief A memoized node.
+     */
+    struct Slot {
+        quint64 counts = 0; ///< The value counts, 6 bits per value from ace to nine and 8 bits for the tens.
+        quint32 hand = 0; ///< The hard total, whether an ace was drawn and the kind of node, 0 if empty.
+        Outcome outcome; ///< The probabilities.
+    };
+
+    /**
+     * @brief Deals the hole card and plays the dealer's hand.
+     * @param upcard The value of the upcard.
+     * @param peeked Whether a natural is ruled out.
+     * @return The probabilities.
+     */
+    Outcome start(qint32 upcard, bool peeked);
+
+    /**
+     * @brief Plays the dealer's hand of two or more cards from the current composition.
+     * @param total The hard total, aces counting 1.
+     * @param ace Whether the hand contains an ace.
+     * @return The probabilities.
+     */
+    Outcome play(qint32 total, bool ace);
+
+    /**
+     * @brief Returns the slot a node is stored in.
+     * @param hand The hand part of the key.
+     * @return The slot.
+     */
+    Slot &slot(quint32 hand);
+
+    /**
+     * @brief Looks a node up in the cache.
+     * @param hand The hand part of the key.
+     * @param outcome Receives the cached probabilities.
+     * @return True if the node was cached, false otherwise.
+     */
+    bool find(quint32 hand, Outcome &outcome);
+
+    /**
+     * @brief Stores a computed node.
+     * @param hand The hand part of the key.
+     * @param outcome The probabilities.
+     */
+    void store(quint32 hand, const Outcome &outcome);
+
+    /**
+     * @brief Loads a composition into the value counts and the packed key.
+     * @param composition The number of cards of every rank from ace to king.
+     */
+    void load(const QVector<qint32> &composition);
+
+    static constexpr qint32 memoizedTotal = 14; ///< The largest hard total of a memoized hand.
+    static const qint32 shifts[11]; ///< The bit offset of every value in the packed counts.
+
+    bool hitsSoft17; ///< Whether the dealer hits a soft 17.
+    QVector<Slot> slots; ///< The memoized nodes, a power of two of them, empty if nothing is memoized.
+    quint64 mask = 0; ///< The number of slots minus one.
+    qint32 counts[11] = {}; ///< The remaining cards of every value from 1 to 10.
+    qint32 remaining = 0; ///< The number of remaining cards.
+    quint64 packed = 0; ///< The counts packed as in Key.
+    qint64 lookups = 0; ///< The number of lookups.
+    qint64 hits = 0; ///< The number of cache hits.
+    qint64 insertions = 0; ///< The number of stored nodes.
+    qint64 evictions = 0; ///< The number of replaced nodes.
+    qint32 entries = 0; ///< The number of occupied slots.
+};
+
+#endif //CARD_COUNTER_DEALEROUTCOMES_HPP
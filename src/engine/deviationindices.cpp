@@ -0,0 +1,470 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <numeric>
+// Qt
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QtMath>
+// own
+#include "deviationindices.hpp"
+#include "blackjackengine.hpp"
+#include "dealeroutcomes.hpp"
+#include "src/strategy/strategy.hpp"
+#include "src/strategy/weightmatrix.hpp"
+#include "src/perf/tracer.hpp"
+
+namespace {
+    const quint32 cacheMagic = 0x43434458; // "CCDX"
+    const quint32 cacheVersion = 2;
+    /// The number of samples of one play drawn from one random generator.
+    constexpr qint64 chunkSize = 1 << 15;
+    /// The fewest samples a true count needs to take part in the fit.
+    constexpr qint64 minimumSamples = 100;
+
+    /**
+     * Plays the two decisions of an index play from the same cards, and settles both against the exact results
+     * of the dealer, which removes the noise of the dealer's draws from the difference.
+     */
+    class DeviationEngine : public BlackjackEngine {
+    public:
+        DeviationEngine(const Rules &rules, const WeightMatrix &weights, qint32 deckCount, quint64 seed)
+                : BlackjackEngine(rules, weights, deckCount, seed), outcomes(rules, 1 << 20) {
+            dealerOutcomes = &outcomes;
+        }
+
+        /**
+         * Adds the gains of the deviation over the basic decision to the buckets of the true counts.
+         */
+        void sample(const DeviationIndices::Play &play, qint64 samples, Bucket *buckets) {
+            const bool insurance = !play.first;
+            qint64 done = 0;
+            while (done < samples) {
+                // a fresh shoe dealt to a random depth for every sample: reusing the rest of a shoe would
+                // pile up the removed cards of the play and skew its composition at every true count
+                shuffle();
+                for (qint32 depth = qint32(generator.bounded(quint32(reshuffleAt))); depth > 0; depth--) {
+                    draw();
+                }
+                const qint64 shoes = result.shoes;
+                Hand player;
+                Hand dealer;
+                const bool dealt = insurance ? deal(1, dealer)
+                                             : deal(play.first, player) && deal(play.upcard, dealer)
+                                               && deal(play.second, player);
+                if (!dealt) {
+                    continue;
+                }
+                bucketize();
+                const qint32 trueCount = trueCounts[0];
+
+                double gain;
+                if (insurance) {
+                    // half a bet pays 2 to 1 if the hole card is a ten
+                    gain = draw() == 10 ? 1 : -0.5;
+                    if (result.shoes != shoes) {
+                        continue;
+                    }
+                } else {
+                    dealer.add(draw());
+                    if (dealer.best() == 21 || result.shoes != shoes) {
+                        continue; // the dealer peeked, both decisions lose the same
+                    }
+                    const qint32 start = position;
+                    const QVector<qint32> startCounts = counts;
+                    const bool startCutCard = cutCard;
+                    const double basic = playHands(player, dealer, &play.basic);
+                    position = start;
+                    counts = startCounts;
+                    cutCard = startCutCard;
+                    const double deviation = playHands(player, dealer, &play.deviation);
+                    if (result.shoes != shoes) {
+                        continue; // a reshuffle in the middle broke the common cards
+                    }
+                    gain = deviation - basic;
+                }
+                Bucket &bucket = buckets[trueCount];
+                bucket.rounds++;
+                bucket.total += gain;
+                bucket.squares += gain * gain;
+                done++;
+            }
+        }
+
+    private:
+        DealerOutcomes outcomes; ///< The cache of the dealer's results, one per engine and so per thread.
+
+        /**
+         * Swaps a random card of the given value to the front of the rest of the shoe and deals it to a hand.
+         * Taking the first such card instead would leave no card of the value right behind it.
+         */
+        bool deal(qint32 cardValue, Hand &hand) {
+            qint32 candidates = 0;
+            for (qint32 i = position; i < shoe.size(); i++) {
+                candidates += shoe[i] && value(shoe[i]) == cardValue;
+            }
+            if (!candidates) {
+                return false;
+            }
+            qint32 pick = qint32(generator.bounded(quint32(candidates)));
+            for (qint32 i = position; i < shoe.size(); i++) {
+                if (shoe[i] && value(shoe[i]) == cardValue && !pick--) {
+                    std::swap(shoe[position], shoe[i]);
+                    break;
+                }
+            }
+            hand.add(draw());
+            return true;
+        }
+    };
+
+    /**
+     * Fits a line through the mean gains of the true counts in [low, high], weighted by their samples.
+     * Returns false if there are not enough of them.
+     */
+    bool fitLine(const QVector<BlackjackEngine::Bucket> &buckets, double low, double high,
+                 double &slope, double &intercept) {
+        double weights = 0;
+        double x = 0;
+        double y = 0;
+        double xx = 0;
+        double xy = 0;
+        // the outermost buckets collect everything beyond them, they have no center
+        for (qint32 i = 1; i + 1 < buckets.size(); i++) {
+            const BlackjackEngine::Bucket &bucket = buckets[i];
+            const double center = BlackjackEngine::minTrueCount + i + 0.5; // true counts are rounded down
+            if (bucket.rounds < minimumSamples || center < low || center > high) {
+                continue;
+            }
+            weights += bucket.rounds;
+            x += bucket.rounds * center;
+            y += bucket.rounds * bucket.ev();
+            xx += bucket.rounds * center * center;
+            xy += bucket.rounds * center * bucket.ev();
+        }
+        const double denominator = weights * xx - x * x;
+        if (denominator <= 0) {
+            return false;
+        }
+        slope = (weights * xy - x * y) / denominator;
+        intercept = (y - slope * x) / weights;
+        return slope != 0;
+    }
+
+    /**
+     * Finds the true count at which the gain of the deviation crosses zero: a line through all true counts
+     * locates the crossing, a second one through the true counts around it, where the gain is close to
+     * linear, gives the index.
+     */
+    DeviationIndices::Entry fit(const DeviationIndices::Play &play, const QVector<BlackjackEngine::Bucket> &buckets) {
+        DeviationIndices::Entry entry;
+        entry.play = QString::fromLatin1(play.name);
+        for (const BlackjackEngine::Bucket &bucket: buckets) {
+            entry.samples += bucket.rounds;
+        }
+        double slope;
+        double intercept;
+        if (!fitLine(buckets, BlackjackEngine::minTrueCount, BlackjackEngine::maxTrueCount, slope, intercept)) {
+            return entry;
+        }
+        const double estimate = -intercept / slope;
+        if (!fitLine(buckets, estimate - 3, estimate + 3, slope, intercept)) {
+            return entry;
+        }
+        const double root = -intercept / slope;
+        entry.above = slope > 0;
+        entry.valid = root >= BlackjackEngine::minTrueCount && root <= BlackjackEngine::maxTrueCount;
+        entry.index = entry.valid ? qRound(root) : 0;
+        return entry;
+    }
+
+    /**
+     * The expectations of the player's decisions for a remaining composition, settled against the exact results
+     * of the dealer, who has no natural. Hands of hard 17 or more always stand and the split hands of a pair are
+     * played as if they drew from separate shoes.
+     */
+    class Expectation {
+    public:
+        Expectation(const Rules &rules, qint32 upcard) : dealer(rules), upcard(upcard) {}
+
+        /**
+         * The value of a hand standing.
+         */
+        double stand(qint32 hard, bool ace, const QVector<qint32> &composition) {
+            const qint32 total = ace && hard + 10 <= 21 ? hard + 10 : hard;
+            if (total > 21) {
+                return -1;
+            }
+            const DealerOutcomes::Outcome outcome = dealer.compute(composition, upcard, true);
+            double value = outcome.probability(DealerOutcomes::Bust);
+            for (qint32 result = DealerOutcomes::Seventeen; result <= DealerOutcomes::TwentyOne; result++) {
+                const qint32 dealerTotal = 17 + result;
+                value += ((total > dealerTotal) - (total < dealerTotal)) * outcome.probabilities[result];
+            }
+            return value;
+        }
+
+        /**
+         * The value of a hand taking a card and playing on with the better decision.
+         */
+        double hit(qint32 hard, bool ace, QVector<qint32> &composition) {
+            return draw(composition, [&](qint32 card) {
+                return best(hard + card, ace || card == 1, composition);
+            });
+        }
+
+        /**
+         * The value of a hand doubling, taking exactly one card for twice the bet.
+         */
+        double doubleDown(qint32 hard, bool ace, QVector<qint32> &composition) {
+            return 2 * draw(composition, [&](qint32 card) {
+                return stand(hard + card, ace || card == 1, composition);
+            });
+        }
+
+        /**
+         * The value of splitting a pair, every hand starting with one card of the pair.
+         */
+        double split(qint32 card, QVector<qint32> &composition) {
+            return 2 * draw(composition, [&](qint32 second) {
+                return best(card + second, card == 1 || second == 1, composition);
+            });
+        }
+
+    private:
+        double best(qint32 hard, bool ace, QVector<qint32> &composition) {
+            const qint32 total = ace && hard + 10 <= 21 ? hard + 10 : hard;
+            if (hard > 21) {
+                return -1;
+            }
+            if (total == 21 || hard >= 17) {
+                return stand(hard, ace, composition);
+            }
+            return qMax(stand(hard, ace, composition), hit(hard, ace, composition));
+        }
+
+        /**
+         * Averages a value over the next card, the ten-valued ranks merged into one.
+         */
+        template<typename Value>
+        double draw(QVector<qint32> &composition, Value value) {
+            const qint32 remaining = std::accumulate(composition.cbegin(), composition.cend(), 0);
+            double expectation = 0;
+            for (qint32 card = 1; card <= 10; card++) {
+                qint32 count = composition[card - 1];
+                qint32 rank = card - 1;
+                if (card == 10) {
+                    count = std::accumulate(composition.cbegin() + 9, composition.cend(), 0);
+                    // the dealer only sees values, so any ten-valued rank left stands for all of them
+                    while (rank < 12 && !composition[rank]) {
+                        rank++;
+                    }
+                }
+                if (!count) {
+                    continue;
+                }
+                composition[rank]--;
+                expectation += double(count) / remaining * value(card);
+                composition[rank]++;
+            }
+            return expectation;
+        }
+
+        DealerOutcomes dealer; ///< The dealer's results, shared by all compositions of a play.
+        qint32 upcard; ///< The value of the dealer's upcard.
+    };
+
+    /**
+     * Removes a card of a value from a composition, a ten-valued one from the first ten-valued rank left.
+     */
+    void removeValue(QVector<qint32> &composition, qint32 value) {
+        qint32 rank = value - 1;
+        while (value == 10 && rank < 12 && !composition[rank]) {
+            rank++;
+        }
+        composition[rank]--;
+    }
+}
+
+const QVector<DeviationIndices::Play> &DeviationIndices::plays() {
+    using namespace BasicStrategy;
+    static const QVector<Play> plays = {
+            {"Insurance",  0,  0,  1,  Stand, Stand},
+            {"16 vs 10",   10, 6,  10, Hit,   Stand},
+            {"15 vs 10",   10, 5,  10, Hit,   Stand},
+            {"10,10 vs 5", 10, 10, 5,  Stand, Split},
+            {"10,10 vs 6", 10, 10, 6,  Stand, Split},
+            {"10 vs 10",   6,  4,  10, Hit,   Double},
+            {"12 vs 3",    10, 2,  3,  Hit,   Stand},
+            {"12 vs 2",    10, 2,  2,  Hit,   Stand},
+            {"11 vs A",    6,  5,  1,  Hit,   Double},
+            {"9 vs 2",     5,  4,  2,  Hit,   Double},
+            {"10 vs A",    6,  4,  1,  Hit,   Double},
+            {"9 vs 7",     5,  4,  7,  Hit,   Double},
+            {"16 vs 9",    10, 6,  9,  Hit,   Stand},
+            {"13 vs 2",    10, 3,  2,  Stand, Hit},
+            {"12 vs 4",    10, 2,  4,  Stand, Hit},
+            {"12 vs 5",    10, 2,  5,  Stand, Hit},
+            {"12 vs 6",    10, 2,  6,  Stand, Hit},
+            {"13 vs 3",    10, 3,  3,  Stand, Hit},
+    };
+    return plays;
+}
+
+QVector<double> DeviationIndices::effectOfRemoval(const Rules &rules, const Play &play) {
+    CC_TRACE_SPAN("DeviationIndices::effectOfRemoval");
+    QVector<qint32> composition = DealerOutcomes::fullShoe(1);
+    removeValue(composition, play.upcard);
+    Expectation expectation(rules, play.upcard);
+    const qint32 hard = play.first + play.second;
+    const bool ace = play.first == 1 || play.second == 1;
+    const auto value = [&](BasicStrategy::Action action, QVector<qint32> &cards) {
+        switch (action) {
+            case BasicStrategy::Hit:
+                return expectation.hit(hard, ace, cards);
+            case BasicStrategy::Double:
+                return expectation.doubleDown(hard, ace, cards);
+            case BasicStrategy::Split:
+                return expectation.split(play.first, cards);
+            case BasicStrategy::Stand:
+            default:
+                return expectation.stand(hard, ace, cards);
+        }
+    };
+    const auto gain = [&](QVector<qint32> &cards) {
+        if (!play.first) {
+            // the insurance bet pays 2 to 1 if the hole card is ten-valued
+            const qint32 tens = std::accumulate(cards.cbegin() + 9, cards.cend(), 0);
+            const qint32 remaining = std::accumulate(cards.cbegin(), cards.cend(), 0);
+            return (3.0 * tens - remaining) / remaining;
+        }
+        return value(play.deviation, cards) - value(play.basic, cards);
+    };
+
+    if (play.first) {
+        removeValue(composition, play.first);
+        removeValue(composition, play.second);
+    }
+    const double base = gain(composition);
+    QVector<double> effects(13);
+    for (qint32 rank = 0; rank < 13; rank++) {
+        if (rank > 9) {
+            // the ten-valued ranks only differ by name
+            effects[rank] = effects[9];
+            continue;
+        }
+        composition[rank]--;
+        effects[rank] = 100 * (gain(composition) - base);
+        composition[rank]++;
+    }
+    return effects;
+}
+
+QVector<DeviationIndices::Entry> DeviationIndices::compute(const Rules &rules, const QVector<qint32> &weights,
+                                                           qint32 deckCount, qint64 samples, quint64 seed) {
+    CC_TRACE_SPAN("DeviationIndices::compute");
+    Strategy strategy(QString(), QString(), weights, true);
+    const WeightMatrix matrix({&strategy});
+    const QVector<Play> &table = plays();
+    const qint64 chunkCount = (samples + chunkSize - 1) / chunkSize;
+
+    // one task per play and chunk, every task with its own buckets
+    QVector<qint64> tasks(table.size() * chunkCount);
+    std::iota(tasks.begin(), tasks.end(), 0);
+    QVector<BlackjackEngine::Bucket> partial(tasks.size() * BlackjackEngine::bucketCount);
+    BlackjackEngine::Bucket *out = partial.data();
+    QtConcurrent::blockingMap(tasks, [&, out](qint64 task) {
+        const qint64 play = task / chunkCount;
+        const qint64 chunk = task % chunkCount;
+        DeviationEngine engine(rules, matrix, deckCount, seed + 0x9e3779b97f4a7c15ULL * quint64(task + 1));
+        engine.sample(table[play], qMin(chunkSize, samples - chunk * chunkSize),
+                      out + task * BlackjackEngine::bucketCount);
+    });
+
+    // merged in chunk order, so the sums do not depend on the scheduling
+    QVector<Entry> entries;
+    for (qint32 play = 0; play < table.size(); play++) {
+        QVector<BlackjackEngine::Bucket> buckets(BlackjackEngine::bucketCount);
+        for (qint64 chunk = 0; chunk < chunkCount; chunk++) {
+            for (qint32 i = 0; i < BlackjackEngine::bucketCount; i++) {
+                buckets[i].merge(partial[(play * chunkCount + chunk) * BlackjackEngine::bucketCount + i]);
+            }
+        }
+        entries.push_back(fit(table[play], buckets));
+    }
+    return entries;
+}
+
+QVector<DeviationIndices::Entry> DeviationIndices::load(const Rules &rules, const QVector<qint32> &weights,
+                                                        qint32 deckCount, qint64 samples, quint64 seed) {
+    const QString path = cachePath(rules, weights, deckCount, samples);
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&file);
+        quint32 magic;
+        quint32 version;
+        qint32 count;
+        stream >> magic >> version >> count;
+        if (magic == cacheMagic && version == cacheVersion && count == plays().size()) {
+            QVector<Entry> entries(count);
+            for (Entry &entry: entries) {
+                stream >> entry.play >> entry.index >> entry.above >> entry.valid >> entry.samples;
+            }
+            if (stream.status() == QDataStream::Ok) {
+                return entries;
+            }
+        }
+    }
+
+    const QVector<Entry> entries = compute(rules, weights, deckCount, samples, seed);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile cache(path);
+    if (cache.open(QIODevice::WriteOnly)) {
+        QDataStream stream(&cache);
+        stream << cacheMagic << cacheVersion << qint32(entries.size());
+        for (const Entry &entry: entries) {
+            stream << entry.play << entry.index << entry.above << entry.valid << entry.samples;
+        }
+        cache.commit();
+    }
+    return entries;
+}
+
+QString DeviationIndices::cachePath(const Rules &rules, const QVector<qint32> &weights, qint32 deckCount,
+                                    qint64 samples) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (qint32 weight: weights) {
+        hash.addData(QByteArray::number(weight) + ',');
+    }
+    hash.addData(QByteArray::number(deckCount) + ',' + QByteArray::number(samples) + ',');
+    hash.addData(QByteArray::number(rules.dealerHitsSoft17) + QByteArray::number(rules.doubleAfterSplit)
+                 + QByteArray::number(rules.resplitAces) + QByteArray::number(rules.maxHands) + ','
+                 + QByteArray::number(rules.blackjackPays) + ',' + QByteArray::number(rules.penetration) + ','
+                 + QByteArray::number(rules.jokers));
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           + QStringLiteral("/deviations/")
+           + QString::fromLatin1(hash.result().toHex()) + QStringLiteral(".bin");
+}
@@ -0,0 +1,121 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_DEVIATIONINDICES_HPP
+#define CARD_COUNTER_DEVIATIONINDICES_HPP
+
+// Qt
+#include <QString>
+#include <QVector>
+// own
+#include "rules.hpp"
+#include "basicstrategy.hpp"
+
+/**
+ * @brief The DeviationIndices class computes the true counts at which the common index plays flip from basic
+ * strategy to the deviation, for the weights of any strategy.
+ *
+ * Every sample deals a shoe to a random depth, moves the cards of the play to the front of the rest, and plays
+ * the hand once with the basic decision and once with the deviation from the same following cards (common
+ * random numbers), so only the difference of the two returns is noisy, not the returns themselves. The dealer's
+ * hand is not dealt out: both returns are settled against the exact results of the dealer for the remaining
+ * cards from DealerOutcomes, which takes the dealer's draws out of the noise. The differences are averaged per
+ * true count and the index is the zero of a weighted linear fit. The samples of
+ * all plays run in seeded chunks on the global thread pool, the tables are cached on disk per weights,
+ * deck count, rules and sample count.
+ */
+class DeviationIndices {
+public:
+    /**
+     * @brief An index play: a two-card hand against an upcard and the two decisions compared.
+     */
+    struct Play {
+        const char *name; ///< The usual name of the play.
+        qint32 first; ///< The value of the player's first card, 0 for the insurance bet.
+        qint32 second; ///< The value of the player's second card, 0 for the insurance bet.
+        qint32 upcard; ///< The value of the dealer's upcard, 1 for an ace.
+        BasicStrategy::Action basic; ///< The basic strategy decision.
+        BasicStrategy::Action deviation; ///< The decision at the other side of the index.
+    };
+
+    /**
+     * @brief The index of one play.
+     */
+    struct Entry {
+        QString play; ///< The name of the play.
+        qint32 index = 0; ///< The true count at which the deviation starts.
+        bool above = true; ///< Whether the deviation is played at or above the index, at or below otherwise.
+        bool valid = false; ///< Whether the gain of the deviation crossed zero within the true count range.
+        qint64 samples = 0; ///< The number of compared hands.
+    };
+
+    /**
+     * @brief Returns the plays an index table is computed for, the insurance bet and the Illustrious 18
+     * with the Fab 4 surrender plays left out.
+     * @return The plays.
+     */
+    static const QVector<Play> &plays();
+
+    /**
+     * @brief Computes the effect of removal of a play: how much the gain of the deviation over the basic decision
+     * changes when one card of a rank leaves a single deck, from the exact results of the dealer.
+     * @param rules The table rules.
+     * @param play The play.
+     * @return The changes in percent of the bet for every rank from ace to king.
+     */
+    static QVector<double> effectOfRemoval(const Rules &rules, const Play &play);
+
+    /**
+     * @brief Computes the index table of a strategy.
+     * @param rules The table rules.
+     * @param weights The 13 weights from ace to king.
+     * @param deckCount The number of decks per shoe, 1 to 10.
+     * @param samples The number of compared hands per play.
+     * @param seed The seed of the run.
+     * @return The indices in the order of plays().
+     */
+    static QVector<Entry> compute(const Rules &rules, const QVector<qint32> &weights, qint32 deckCount,
+                                  qint64 samples, quint64 seed);
+
+    /**
+     * @brief Returns the cached index table, computing and caching it if it is not on disk yet.
+     * @param rules The table rules.
+     * @param weights The 13 weights from ace to king.
+     * @param deckCount The number of decks per shoe, 1 to 10.
+     * @param samples The number of compared hands per play.
+     * @param seed The seed used when the table has to be computed.
+     * @return The indices in the order of plays().
+     */
+    static QVector<Entry> load(const Rules &rules, const QVector<qint32> &weights, qint32 deckCount,
+                               qint64 samples, quint64 seed);
+
+private:
+    /**
+     * @brief Returns the file the index table is cached in.
+     * @param rules The table rules.
+     * @param weights The 13 weights from ace to king.
+     * @param deckCount The number of decks per shoe.
+     * @param samples The number of compared hands per play.
+     * @return The absolute path of the cache file.
+     */
+    static QString cachePath(const Rules &rules, const QVector<qint32> &weights, qint32 deckCount, qint64 samples);
+};
+
+#endif //CARD_COUNTER_DEVIATIONINDICES_HPP
@@ -0,0 +1,48 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_RULES_HPP
+#define CARD_COUNTER_RULES_HPP
+
+// Qt
+#include <QtGlobal>
+
+/**
+ * @brief The Rules struct describes the table rules the blackjack engine plays by.
+ */
+struct Rules {
+    /**
+     * @brief What happens when a joker comes out of the shoe.
+     */
+    enum Jokers {
+        Burn = 0, /**< The joker is discarded and the next card is dealt. */
+        CutCard /**< The joker is discarded and the shoe is reshuffled after the round. */
+    };
+
+    bool dealerHitsSoft17 = false; ///< Whether the dealer hits a soft 17 (H17) instead of standing (S17).
+    bool doubleAfterSplit = true; ///< Whether split hands may be doubled.
+    bool resplitAces = false; ///< Whether split aces may be split again.
+    qint32 maxHands = 4; ///< The largest number of hands a player can split into.
+    double blackjackPays = 1.5; ///< The payout of a natural blackjack.
+    double penetration = 0.75; ///< The fraction of the shoe dealt before the next round reshuffles.
+    Jokers jokers = Burn; ///< The handling of the jokers of the shoe.
+};
+
+#endif //CARD_COUNTER_RULES_HPP
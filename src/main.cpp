@@ -18,17 +18,162 @@
  *
 */
 
+// std
+#include <algorithm>
 // Qt
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QThreadPool>
 // KF
 #include <KAboutData>
 #include <KLocalizedString>
+#include <KConfigGroup>
+#include <KSharedConfig>
 // own
 #include "mainwindow.hpp"
+#include "src/perf/tracer.hpp"
+#include "src/strategy/strategy.hpp"
+#include "src/strategy/strategycatalog.hpp"
+#include "src/strategy/strategyoptimizer.hpp"
+#include "src/simulation/simulator.hpp"
+
+/**
+ * @brief Checks whether the command line asks for a mode that runs without any display.
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return True if no QApplication must be created, false otherwise.
+ */
+static bool isHeadless(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const QByteArray argument = QByteArray(argv[i]).replace("--", "-");
+        if (argument == "-simulate" || argument == "-optimize" || argument.startsWith("-optimize=")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Counts shuffled shoes with the chosen strategies and writes the statistics.
+ * @param strategyNames The names of the strategies, all of them if empty.
+ * @param deckCounts The numbers of decks per shoe.
+ * @param shoes The number of shoes per deck count.
+ * @param seed The seed of the run.
+ * @param rules The rules to play blackjack rounds by, or nullptr to only count the shoes.
+ * @param samples The number of compared hands per deviation index, or 0 not to compute any.
+ * @param json Whether to write JSON instead of CSV.
+ * @param outputPath The file to write to, the standard output if empty.
+ * @return The exit code.
+ */
+static int simulate(const QStringList &strategyNames, const QVector<qint32> &deckCounts, qint32 shoes, quint64 seed,
+                    const Rules *rules, qint64 samples, bool json, const QString &outputPath) {
+    QTextStream err(stderr);
+    const QVector<Strategy *> available = Strategy::loadStrategies(
+            KConfigGroup(KSharedConfig::openConfig(), "CCStrategies"));
+    QVector<Strategy *> strategies;
+    for (const QString &name: strategyNames) {
+        auto found = std::find_if(available.begin(), available.end(),
+                                  [&](Strategy *strategy) { return strategy->getName() == name; });
+        if (found == available.end()) {
+            err << i18n("Unknown strategy: %1", name) << Qt::endl;
+            return 1;
+        }
+        strategies.push_back(*found);
+    }
+    if (strategies.isEmpty()) {
+        strategies = available;
+    }
+    for (qint32 deckCount: deckCounts) {
+        if (deckCount < 1 || deckCount > 10) {
+            err << i18n("The number of decks must be between 1 and 10.") << Qt::endl;
+            return 1;
+        }
+    }
+    if (deckCounts.isEmpty() || shoes < 1) {
+        err << i18n("Nothing to simulate.") << Qt::endl;
+        return 1;
+    }
+
+    const Simulator::Report report =
+            rules && samples ? Simulator::deviations(strategies, deckCounts, samples, seed, *rules)
+            : rules ? Simulator::playRounds(strategies, deckCounts, shoes, seed, *rules)
+            : Simulator::run(strategies, deckCounts, shoes, seed);
+    QFile output(outputPath);
+    bool opened = outputPath.isEmpty() ? output.open(stdout, QIODevice::WriteOnly)
+                                       : output.open(QIODevice::WriteOnly);
+    if (!opened) {
+        err << i18n("Cannot write %1: %2", outputPath, output.errorString()) << Qt::endl;
+        return 1;
+    }
+    output.write(json ? Simulator::toJson(report) : Simulator::toCsv(report));
+    if (rules && samples) {
+        err << i18n("%1 deviation indices in %2 s on %3 threads (seed %4)",
+                    report.deviationRows.size(), QString::number(report.elapsedNsecs / 1e9, 'f', 3), report.threads,
+                    QString::number(report.seed)) << Qt::endl;
+    } else if (rules) {
+        err << i18n("%1 shoes, %2 rounds in %3 s on %4 threads: %5 rounds/s (seed %6)",
+                    report.shoes, report.rounds, QString::number(report.elapsedNsecs / 1e9, 'f', 3), report.threads,
+                    QString::number(report.roundsPerSecond(), 'f', 0), QString::number(report.seed)) << Qt::endl;
+    } else {
+        err << i18n("%1 shoes, %2 cards in %3 s on %4 threads: %5 shoes/s, %6 cards/s (seed %7)",
+                    report.shoes, report.cards, QString::number(report.elapsedNsecs / 1e9, 'f', 3), report.threads,
+                    QString::number(report.shoesPerSecond(), 'f', 0),
+                    QString::number(report.cardsPerSecond(), 'f', 0), QString::number(report.seed)) << Qt::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Searches the best weights for a metric, prints every improvement and saves the winner.
+ * @param metricName One of "betting", "playing" and "insurance".
+ * @param maxLevel The largest absolute weight.
+ * @param balanced Whether the weights must be balanced.
+ * @return The exit code.
+ */
+static int optimizeStrategy(const QString &metricName, qint32 maxLevel, bool balanced) {
+    QTextStream out(stdout);
+    const qint32 index = QStringList{"betting", "playing", "insurance"}.indexOf(metricName);
+    if (index < 0) {
+        QTextStream(stderr) << i18n("Unknown metric: %1", metricName) << Qt::endl;
+        return 1;
+    }
+    const auto metric = StrategyMetrics::Metric(index);
+    StrategyOptimizer optimizer;
+    // the improvements are reported under the lock of the optimizer, so the workers can print directly
+    QObject::connect(&optimizer, &StrategyOptimizer::candidateFound, [&](const QVector<qint32> &weights, double score) {
+        QStringList values;
+        for (qint32 weight: weights) {
+            values.push_back(QString::number(weight));
+        }
+        out << QString::number(score, 'f', 4) << '\t' << values.join(QLatin1Char(',')) << Qt::endl;
+    }, Qt::DirectConnection);
+    QElapsedTimer timer;
+    timer.start();
+    optimizer.start(metric, maxLevel, balanced).waitForFinished();
+    const StrategyOptimizer::Result result = optimizer.result();
+    if (result.weights.isEmpty()) {
+        QTextStream(stderr) << i18n("No weights satisfy the constraints.") << Qt::endl;
+        return 1;
+    }
+    Strategy strategy(StrategyOptimizer::strategyName(metric, maxLevel, balanced),
+                      StrategyOptimizer::strategyDescription(metric, result.score), result.weights, true);
+    KConfigGroup strategiesGroup(KSharedConfig::openConfig(), "CCStrategies");
+    strategy.save(strategiesGroup);
+    StrategyCatalog::bumpGeneration(strategiesGroup);
+    strategiesGroup.sync();
+    out << i18n("Saved \"%1\" after %2 nodes in %3 ms.", strategy.getName(), result.nodes, timer.elapsed())
+        << Qt::endl;
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
+    // the batch modes run on build servers without a display
+    QScopedPointer<QCoreApplication> app(isHeadless(argc, argv) ? new QCoreApplication(argc, argv)
+                                                                : new QApplication(argc, argv));
     KLocalizedString::setApplicationDomain("card-counter");
 
     KAboutData aboutData(
@@ -51,12 +196,125 @@ int main(int argc, char *argv[]) {
     KAboutData::setApplicationData(aboutData);
 
     QCommandLineParser parser;
+    QCommandLineOption traceOption(QStringLiteral("trace"),
+                                   i18n("Record hot-path spans and write them as Chrome trace JSON to <file> on exit "
+                                        "(or set CARD_COUNTER_TRACE)."),
+                                   QStringLiteral("file"));
+    parser.addOption(traceOption);
+    QCommandLineOption optimizeOption(QStringLiteral("optimize"),
+                                      i18n("Search the weights maximizing <metric> (betting, playing or insurance), "
+                                           "save them as a custom strategy and exit."),
+                                      QStringLiteral("metric"));
+    parser.addOption(optimizeOption);
+    QCommandLineOption maxLevelOption(QStringLiteral("max-level"),
+                                      i18n("The largest absolute weight the optimizer tries, 1 to 5 (default 2)."),
+                                      QStringLiteral("level"), QStringLiteral("2"));
+    parser.addOption(maxLevelOption);
+    QCommandLineOption unbalancedOption(QStringLiteral("unbalanced"),
+                                        i18n("Let the optimizer try unbalanced weights as well."));
+    parser.addOption(unbalancedOption);
+    QCommandLineOption simulateOption(QStringLiteral("simulate"),
+                                      i18n("Count shuffled shoes without a display, write the statistics and exit."));
+    parser.addOption(simulateOption);
+    QCommandLineOption strategiesOption(QStringLiteral("strategies"),
+                                        i18n("The comma-separated strategies to simulate (default all)."),
+                                        QStringLiteral("names"));
+    parser.addOption(strategiesOption);
+    QCommandLineOption decksOption(QStringLiteral("decks"),
+                                   i18n("The comma-separated numbers of decks per shoe to simulate (default 6)."),
+                                   QStringLiteral("counts"), QStringLiteral("6"));
+    parser.addOption(decksOption);
+    QCommandLineOption shoesOption(QStringLiteral("shoes"),
+                                   i18n("The number of shoes per number of decks (default 10000)."),
+                                   QStringLiteral("count"), QStringLiteral("10000"));
+    parser.addOption(shoesOption);
+    QCommandLineOption threadsOption(QStringLiteral("threads"),
+                                     i18n("The number of worker threads (default all cores)."),
+                                     QStringLiteral("count"));
+    parser.addOption(threadsOption);
+    QCommandLineOption seedOption(QStringLiteral("seed"),
+                                  i18n("The seed of the simulation (default random)."),
+                                  QStringLiteral("seed"));
+    parser.addOption(seedOption);
+    QCommandLineOption formatOption(QStringLiteral("format"),
+                                    i18n("The output format of the simulation, csv or json (default csv)."),
+                                    QStringLiteral("format"), QStringLiteral("csv"));
+    parser.addOption(formatOption);
+    QCommandLineOption outputOption(QStringLiteral("output"),
+                                    i18n("The file the simulation writes to (default the standard output)."),
+                                    QStringLiteral("file"));
+    parser.addOption(outputOption);
+    QCommandLineOption blackjackOption(QStringLiteral("blackjack"),
+                                       i18n("Let the simulation play basic strategy blackjack rounds and write "
+                                            "the return per true count."));
+    parser.addOption(blackjackOption);
+    QCommandLineOption deviationsOption(QStringLiteral("deviations"),
+                                        i18n("Let the simulation compute the playing deviation indices of every "
+                                             "strategy and write them."));
+    parser.addOption(deviationsOption);
+    QCommandLineOption samplesOption(QStringLiteral("samples"),
+                                     i18n("The number of compared hands per deviation index (default 1000000)."),
+                                     QStringLiteral("count"), QStringLiteral("1000000"));
+    parser.addOption(samplesOption);
+    QCommandLineOption h17Option(QStringLiteral("h17"), i18n("The dealer hits a soft 17."));
+    parser.addOption(h17Option);
+    QCommandLineOption noDasOption(QStringLiteral("no-das"), i18n("Split hands may not be doubled."));
+    parser.addOption(noDasOption);
+    QCommandLineOption penetrationOption(QStringLiteral("penetration"),
+                                         i18n("The fraction of the shoe dealt before reshuffling (default 0.75)."),
+                                         QStringLiteral("fraction"), QStringLiteral("0.75"));
+    parser.addOption(penetrationOption);
+    QCommandLineOption jokersOption(QStringLiteral("jokers"),
+                                    i18n("What a joker does in a round, burn or cut (reshuffle after the round, "
+                                         "default burn)."),
+                                    QStringLiteral("handling"), QStringLiteral("burn"));
+    parser.addOption(jokersOption);
     aboutData.setupCommandLine(&parser);
-    parser.process(app);
+    parser.process(*app);
     aboutData.processCommandLine(&parser);
 
+    QString tracePath = parser.isSet(traceOption) ? parser.value(traceOption)
+                                                  : qEnvironmentVariable("CARD_COUNTER_TRACE");
+    if (!tracePath.isEmpty()) {
+        Tracer::instance()->start(tracePath);
+    }
+
+    if (parser.isSet(threadsOption) && parser.value(threadsOption).toInt() > 0) {
+        QThreadPool::globalInstance()->setMaxThreadCount(parser.value(threadsOption).toInt());
+    }
+
+    if (parser.isSet(simulateOption)) {
+        QVector<qint32> deckCounts;
+        for (const QString &value: parser.value(decksOption).split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+            deckCounts.push_back(value.toInt());
+        }
+        quint64 seed = parser.isSet(seedOption) ? parser.value(seedOption).toULongLong()
+                                                : QRandomGenerator::global()->generate64();
+        Rules rules;
+        rules.dealerHitsSoft17 = parser.isSet(h17Option);
+        rules.doubleAfterSplit = !parser.isSet(noDasOption);
+        rules.penetration = qBound(0.1, parser.value(penetrationOption).toDouble(), 1.0);
+        rules.jokers = parser.value(jokersOption) == QLatin1String("cut") ? Rules::CutCard : Rules::Burn;
+        int result = simulate(parser.value(strategiesOption).split(QLatin1Char(','), Qt::SkipEmptyParts),
+                              deckCounts, parser.value(shoesOption).toInt(), seed,
+                              parser.isSet(blackjackOption) || parser.isSet(deviationsOption) ? &rules : nullptr,
+                              parser.isSet(deviationsOption) ? qMax(1LL, parser.value(samplesOption).toLongLong()) : 0,
+                              parser.value(formatOption) == QLatin1String("json"), parser.value(outputOption));
+        Tracer::instance()->stop();
+        return result;
+    }
+
+    if (parser.isSet(optimizeOption)) {
+        int result = optimizeStrategy(parser.value(optimizeOption), parser.value(maxLevelOption).toInt(),
+                                      !parser.isSet(unbalancedOption));
+        Tracer::instance()->stop();
+        return result;
+    }
+
     auto *window = new MainWindow();
     window->show();
 
-    return QApplication::exec();
+    int result = QCoreApplication::exec();
+    Tracer::instance()->stop();
+    return result;
 }
@@ -28,6 +28,7 @@
 #include <KLocalizedString>
 #include <KActionCollection>
 #include <KScoreDialog>
+#include <KToggleAction>
 // own
 #include "mainwindow.hpp"
 #include "src/table/table.hpp"
@@ -59,6 +60,11 @@ void MainWindow::setupActions() {
     KStandardAction::preferences(this, &MainWindow::configureSettings, actionCollection());
     m_actionPause = KStandardGameAction::pause(this, &MainWindow::pauseGame, actionCollection());
 
+    auto *perfOverlay = new KToggleAction(i18n("Show &Performance Overlay"), this);
+    actionCollection()->addAction(QStringLiteral("show_perf_overlay"), perfOverlay);
+    actionCollection()->setDefaultShortcut(perfOverlay, Qt::Key_F12);
+    connect(perfOverlay, &KToggleAction::toggled, this, &MainWindow::showPerfOverlay);
+
     Kg::difficulty()->addStandardLevelRange(
             KgDifficultyLevel::Easy, KgDifficultyLevel::Hard, KgDifficultyLevel::Easy
     );
@@ -88,11 +94,25 @@ void MainWindow::onGameOver() {
     Kg::difficulty()->setGameRunning(false);
     QPointer<KScoreDialog> scoreDialog = new KScoreDialog(KScoreDialog::Name | KScoreDialog::Time, this);
     scoreDialog->initFromDifficulty(Kg::difficulty());
+    addAnswerFields(scoreDialog);
 
     KScoreDialog::FieldInfo scoreInfo;
     scoreInfo[KScoreDialog::Score] = i18n("%1/%2", score.first, score.second);
     scoreInfo[KScoreDialog::Time] = m_gameClock->timeString();
 
+    const AnswerStats &answerStats = table->getAnswerStats();
+    if (answerStats.overall().count()) {
+        scoreInfo[KScoreDialog::Custom1] = AnswerStats::formatLatency(answerStats.overall().valueAtPercentile(0.5));
+        scoreInfo[KScoreDialog::Custom2] = AnswerStats::formatLatency(answerStats.overall().valueAtPercentile(0.9));
+        QStringList breakdown;
+        const auto &histograms = answerStats.breakdown();
+        for (auto it = histograms.constBegin(); it != histograms.constEnd(); ++it) {
+            breakdown.push_back(i18n("%1 ×%2: %3", it.key().strategy, it.key().deckCount,
+                                     AnswerStats::formatLatency(it.value().valueAtPercentile(0.5))));
+        }
+        scoreInfo[KScoreDialog::Custom3] = breakdown.join(QStringLiteral("; "));
+    }
+
     if (scoreDialog->addScore(scoreInfo, KScoreDialog::LessIsMore) != 0)
         scoreDialog->exec();
 
@@ -106,6 +126,7 @@ void MainWindow::advanceTime(const QString &timeStr) {
 void MainWindow::showHighScores() {
     QPointer<KScoreDialog> scoreDialog = new KScoreDialog(KScoreDialog::Name | KScoreDialog::Time, this);
     scoreDialog->initFromDifficulty(Kg::difficulty());
+    addAnswerFields(scoreDialog);
     scoreDialog->exec();
     delete scoreDialog;
 }
@@ -132,3 +153,13 @@ void MainWindow::onScoreUpdate(bool inc) {
     score.first += inc;
     scoreLabel->setText(i18n("Score: %1/%2", score.first, score.second));
 }
+
+void MainWindow::showPerfOverlay(bool visible) {
+    table->setOverlayVisible(visible);
+}
+
+void MainWindow::addAnswerFields(KScoreDialog *scoreDialog) {
+    scoreDialog->addField(KScoreDialog::Custom1, i18n("Median Answer"), QStringLiteral("answerMedian"));
+    scoreDialog->addField(KScoreDialog::Custom2, i18n("90% Answer"), QStringLiteral("answerP90"));
+    scoreDialog->addField(KScoreDialog::Custom3, i18n("Median by Strategy"), QStringLiteral("answerBreakdown"));
+}
@@ -33,6 +33,8 @@ class KToggleAction;
 
 class Table;
 
+class KScoreDialog;
+
 class MainWindow : public KXmlGuiWindow {
 Q_OBJECT
 
@@ -88,12 +90,24 @@ private Q_SLOTS:
      */
     void onScoreUpdate(bool inc);
 
+    /**
+     * @brief Shows or hides the performance overlay.
+     * @param visible True to show the overlay, false to hide it.
+     */
+    void showPerfOverlay(bool visible);
+
 private:
     /**
      * @brief Sets up the actions for the main window.
      */
     void setupActions();
 
+    /**
+     * @brief Adds the answer latency columns to a score dialog.
+     * @param scoreDialog The dialog to add the columns to.
+     */
+    void addAnswerFields(KScoreDialog *scoreDialog);
+
     Table *table;
 
     KGameClock *m_gameClock = nullptr;
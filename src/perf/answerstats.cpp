@@ -0,0 +1,57 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// KF
+#include <KLocalizedString>
+// own
+#include "answerstats.hpp"
+
+bool AnswerStats::Key::operator<(const Key &other) const {
+    if (strategy != other.strategy) {
+        return strategy < other.strategy;
+    }
+    if (deckCount != other.deckCount) {
+        return deckCount < other.deckCount;
+    }
+    return difficulty < other.difficulty;
+}
+
+void AnswerStats::record(const Key &key, qint64 nsecs) {
+    qint64 usecs = nsecs / 1000;
+    _overall.record(usecs);
+    _breakdown[key].record(usecs);
+}
+
+void AnswerStats::clear() {
+    _overall = LatencyHistogram();
+    _breakdown.clear();
+}
+
+const LatencyHistogram &AnswerStats::overall() const {
+    return _overall;
+}
+
+const QMap<AnswerStats::Key, LatencyHistogram> &AnswerStats::breakdown() const {
+    return _breakdown;
+}
+
+QString AnswerStats::formatLatency(qint64 usecs) {
+    return i18n("%1 s", QString::number(usecs / 1e6, 'f', 2));
+}
@@ -0,0 +1,83 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_ANSWERSTATS_HPP
+#define CARD_COUNTER_ANSWERSTATS_HPP
+
+// Qt
+#include <QMap>
+#include <QString>
+// own
+#include "latencyhistogram.hpp"
+
+/**
+ * @brief The AnswerStats class collects the joker answer latencies of a game session,
+ * broken down by strategy, number of decks and difficulty.
+ */
+class AnswerStats {
+public:
+    /**
+     * @brief The setup a latency was measured in.
+     */
+    struct Key {
+        QString strategy; ///< The name of the strategy of the table slot.
+        qint32 deckCount; ///< The number of decks of the table slot.
+        QString difficulty; ///< The difficulty level of the game.
+
+        bool operator<(const Key &other) const;
+    };
+
+    /**
+     * @brief Records the time from the presentation of a joker to the submitted answer.
+     * @param key The setup of the table slot.
+     * @param nsecs The latency in nanoseconds.
+     */
+    void record(const Key &key, qint64 nsecs);
+
+    /**
+     * @brief Removes all recorded latencies.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the latencies of all setups.
+     * @return The merged histogram.
+     */
+    const LatencyHistogram &overall() const;
+
+    /**
+     * @brief Returns the latencies per setup.
+     * @return The histograms keyed by setup.
+     */
+    const QMap<Key, LatencyHistogram> &breakdown() const;
+
+    /**
+     * @brief Formats a duration for display.
+     * @param usecs The duration in microseconds.
+     * @return The duration in seconds, e.g. "1.84 s".
+     */
+    static QString formatLatency(qint64 usecs);
+
+private:
+    LatencyHistogram _overall; ///< The latencies of all setups.
+    QMap<Key, LatencyHistogram> _breakdown; ///< The latencies per setup.
+};
+
+#endif //CARD_COUNTER_ANSWERSTATS_HPP
@@ -0,0 +1,68 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// own
+#include "framestats.hpp"
+
+FrameStats *FrameStats::instance() {
+    static FrameStats stats;
+    return &stats;
+}
+
+bool FrameStats::isEnabled() const {
+    return _enabled;
+}
+
+void FrameStats::setEnabled(bool enabled) {
+    _enabled = enabled;
+    slowestPaint = 0;
+    _lastTick = 0;
+}
+
+void FrameStats::addPaint(qint64 nsecs) {
+    slowestPaint = qMax(slowestPaint, nsecs);
+}
+
+void FrameStats::addTick(qint64 nsecs) {
+    _lastTick = nsecs;
+}
+
+void FrameStats::addPixmapLookup(bool hit) {
+    if (hit) {
+        pixmapHits++;
+    } else {
+        pixmapMisses++;
+    }
+}
+
+qint64 FrameStats::takeSlowestPaint() {
+    qint64 slowest = slowestPaint;
+    slowestPaint = 0;
+    return slowest;
+}
+
+qint64 FrameStats::lastTick() const {
+    return _lastTick;
+}
+
+double FrameStats::pixmapHitRate() const {
+    qint64 lookups = pixmapHits + pixmapMisses;
+    return lookups ? double(pixmapHits) / double(lookups) : -1;
+}
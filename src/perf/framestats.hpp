@@ -0,0 +1,98 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_FRAMESTATS_HPP
+#define CARD_COUNTER_FRAMESTATS_HPP
+
+// Qt
+#include <QtGlobal>
+
+/**
+ * @brief The FrameStats class collects the timings shown by the performance overlay.
+ *
+ * The statistics are only gathered while they are enabled and are written and read from the GUI thread.
+ */
+class FrameStats {
+public:
+    /**
+     * @brief Returns the statistics of the application.
+     * @return The FrameStats instance.
+     */
+    static FrameStats *instance();
+
+    /**
+     * @brief Checks whether the timings are currently gathered.
+     * @return True if the statistics are enabled, false otherwise.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Enables or disables gathering the timings.
+     * @param enabled Whether the timings should be gathered.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Records the duration of a Cards::paintEvent.
+     * @param nsecs The duration in nanoseconds.
+     */
+    void addPaint(qint64 nsecs);
+
+    /**
+     * @brief Records the duration of a Table::pickUpCards tick.
+     * @param nsecs The duration in nanoseconds.
+     */
+    void addTick(qint64 nsecs);
+
+    /**
+     * @brief Records a lookup in a pixmap cache.
+     * @param hit Whether the pixmap was found in the cache.
+     */
+    void addPixmapLookup(bool hit);
+
+    /**
+     * @brief Returns the slowest paint since the last call and starts a new measurement window.
+     * @return The duration in nanoseconds.
+     */
+    qint64 takeSlowestPaint();
+
+    /**
+     * @brief Returns the duration of the last deal tick.
+     * @return The duration in nanoseconds.
+     */
+    qint64 lastTick() const;
+
+    /**
+     * @brief Returns the pixmap cache hit rate.
+     * @return The hit rate in [0, 1], or -1 if no pixmap cache was used.
+     */
+    double pixmapHitRate() const;
+
+private:
+    FrameStats() = default;
+
+    bool _enabled = false; ///< Whether the timings are gathered.
+    qint64 slowestPaint = 0; ///< The slowest paint in the current window, in nanoseconds.
+    qint64 _lastTick = 0; ///< The duration of the last deal tick, in nanoseconds.
+    qint64 pixmapHits = 0; ///< The number of pixmap cache hits.
+    qint64 pixmapMisses = 0; ///< The number of pixmap cache misses.
+};
+
+#endif //CARD_COUNTER_FRAMESTATS_HPP
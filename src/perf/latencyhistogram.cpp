@@ -0,0 +1,90 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QtAlgorithms>
+// own
+#include "latencyhistogram.hpp"
+
+qint32 LatencyHistogram::bucketOf(qint64 usecs) {
+    if (usecs < linearBuckets) {
+        return qint32(qMax(qint64(0), usecs));
+    }
+    // the highest set bit is at least 5, the next four bits select the sub-bucket
+    qint32 magnitude = 63 - qint32(qCountLeadingZeroBits(quint64(usecs))) - 4;
+    if (magnitude > magnitudes) {
+        return bucketCount - 1;
+    }
+    qint32 sub = qint32(usecs >> magnitude) - subBuckets;
+    return linearBuckets + (magnitude - 1) * subBuckets + sub;
+}
+
+qint64 LatencyHistogram::valueOf(qint32 bucket) {
+    if (bucket < linearBuckets) {
+        return bucket;
+    }
+    qint32 magnitude = (bucket - linearBuckets) / subBuckets + 1;
+    qint64 sub = (bucket - linearBuckets) % subBuckets + subBuckets;
+    return (sub << magnitude) + (qint64(1) << (magnitude - 1));
+}
+
+void LatencyHistogram::record(qint64 usecs) {
+    usecs = qMax(qint64(0), usecs);
+    counts[bucketOf(usecs)]++;
+    total++;
+    sum += usecs;
+    maximum = qMax(maximum, usecs);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    for (qint32 i = 0; i < bucketCount; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    maximum = qMax(maximum, other.maximum);
+}
+
+qint64 LatencyHistogram::count() const {
+    return total;
+}
+
+qint64 LatencyHistogram::max() const {
+    return maximum;
+}
+
+double LatencyHistogram::mean() const {
+    return total ? double(sum) / double(total) : 0;
+}
+
+qint64 LatencyHistogram::valueAtPercentile(double percentile) const {
+    if (!total) {
+        return 0;
+    }
+    qint64 rank = qMax(qint64(1), qint64(percentile * double(total) + 0.5));
+    qint64 seen = 0;
+    for (qint32 i = 0; i < bucketCount; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return qMin(valueOf(i), maximum);
+        }
+    }
+    return maximum;
+}
@@ -0,0 +1,100 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_LATENCYHISTOGRAM_HPP
+#define CARD_COUNTER_LATENCYHISTOGRAM_HPP
+
+// std
+#include <array>
+// Qt
+#include <QtGlobal>
+
+/**
+ * @brief The LatencyHistogram class is a fixed-size log-linear histogram of durations (HDR-style).
+ *
+ * Values are stored in microseconds: below 32 µs exactly, above with 16 linear sub-buckets per power of two,
+ * which keeps the relative error under 1/16 up to about 70 minutes in less than 4 KiB.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @brief Records one duration.
+     * @param usecs The duration in microseconds, larger values are clamped to the last bucket.
+     */
+    void record(qint64 usecs);
+
+    /**
+     * @brief Adds all values of another histogram.
+     * @param other The histogram to merge into this one.
+     */
+    void merge(const LatencyHistogram &other);
+
+    /**
+     * @brief Returns the number of recorded values.
+     * @return The number of values.
+     */
+    qint64 count() const;
+
+    /**
+     * @brief Returns the largest recorded value.
+     * @return The value in microseconds.
+     */
+    qint64 max() const;
+
+    /**
+     * @brief Returns the mean of the recorded values.
+     * @return The mean in microseconds.
+     */
+    double mean() const;
+
+    /**
+     * @brief Returns the value below which the given fraction of the recorded values lie.
+     * @param percentile The fraction in [0, 1].
+     * @return The value in microseconds, or 0 if the histogram is empty.
+     */
+    qint64 valueAtPercentile(double percentile) const;
+
+private:
+    static constexpr qint32 linearBuckets = 32; ///< The number of exact buckets for the smallest values.
+    static constexpr qint32 subBuckets = 16; ///< The number of linear sub-buckets per power of two.
+    static constexpr qint32 magnitudes = 27; ///< The number of powers of two above the linear range.
+    static constexpr qint32 bucketCount = linearBuckets + magnitudes * subBuckets; ///< The total number of buckets.
+
+    /**
+     * @brief Returns the bucket a value falls into.
+     * @param usecs The value in microseconds.
+     * @return The index of the bucket.
+     */
+    static qint32 bucketOf(qint64 usecs);
+
+    /**
+     * @brief Returns the value represented by a bucket (the middle of its range).
+     * @param bucket The index of the bucket.
+     * @return The value in microseconds.
+     */
+    static qint64 valueOf(qint32 bucket);
+
+    std::array<qint64, bucketCount> counts{}; ///< The number of values per bucket.
+    qint64 total = 0; ///< The number of recorded values.
+    qint64 sum = 0; ///< The sum of the recorded values.
+    qint64 maximum = 0; ///< The largest recorded value.
+};
+
+#endif //CARD_COUNTER_LATENCYHISTOGRAM_HPP
@@ -0,0 +1,106 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+// own
+#include "tracer.hpp"
+
+std::atomic<bool> Tracer::enabled{false};
+
+Tracer::Tracer() {
+    clock.start();
+}
+
+Tracer *Tracer::instance() {
+    static Tracer tracer;
+    return &tracer;
+}
+
+qint64 Tracer::now() const {
+    return clock.nsecsElapsed();
+}
+
+void Tracer::start(const QString &path) {
+    tracePath = path;
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+Tracer::Buffer *Tracer::localBuffer() {
+    static thread_local Buffer *buffer = nullptr;
+    if (!buffer) {
+        buffer = new Buffer;
+        buffer->threadId = quint64(quintptr(QThread::currentThreadId()));
+        QMutexLocker locker(&buffersMutex);
+        buffers.push_back(buffer);
+    }
+    return buffer;
+}
+
+void Tracer::record(const char *name, qint64 begin, qint64 end) {
+    Buffer *buffer = localBuffer();
+    // pairs with stop(): either this write sees tracing disabled or stop() sees it in progress and waits for it
+    buffer->writing.store(true);
+    if (enabled.load()) {
+        quint64 head = buffer->head.load(std::memory_order_relaxed);
+        buffer->events[qint32(head % bufferCapacity)] = {name, begin, end - begin};
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+    buffer->writing.store(false, std::memory_order_release);
+}
+
+bool Tracer::stop() {
+    if (!enabled.exchange(false)) {
+        return false;
+    }
+    QFile file(tracePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("Cannot write the trace file %s", qPrintable(tracePath));
+        return false;
+    }
+    QTextStream out(&file);
+    const qint64 pid = QCoreApplication::applicationPid();
+    bool first = true;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    QMutexLocker locker(&buffersMutex);
+    for (const auto *buffer: buffers) {
+        // a span that started before stop() may still be writing its event
+        while (buffer->writing.load(std::memory_order_acquire)) {
+            QThread::yieldCurrentThread();
+        }
+        quint64 head = buffer->head.load(std::memory_order_acquire);
+        quint64 tail = head > quint64(bufferCapacity) ? head - bufferCapacity : 0;
+        for (quint64 i = tail; i < head; i++) {
+            const Event &event = buffer->events[qint32(i % bufferCapacity)];
+            out << (first ? "\n" : ",\n")
+                << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << pid
+                << ",\"tid\":" << buffer->threadId
+                << ",\"ts\":" << QString::number(event.begin / 1000.0, 'f', 3)
+                << ",\"dur\":" << QString::number(event.duration / 1000.0, 'f', 3) << '}';
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return true;
+}
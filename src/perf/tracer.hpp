@@ -0,0 +1,155 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_TRACER_HPP
+#define CARD_COUNTER_TRACER_HPP
+
+// std
+#include <atomic>
+// Qt
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The Tracer class records timed spans of the hot paths and writes them as Chrome trace JSON.
+ *
+ * Tracing is compiled in but disabled until start() is called, so a disabled span costs one relaxed atomic
+ * load. Every thread writes into its own fixed-size ring buffer without locking; only the first span of
+ * a thread takes a lock to register its buffer. The resulting file can be opened in chrome://tracing or
+ * https://ui.perfetto.dev.
+ */
+class Tracer {
+public:
+    /**
+     * @brief Returns the process-wide tracer.
+     * @return The tracer instance.
+     */
+    static Tracer *instance();
+
+    /**
+     * @brief Checks whether spans are currently recorded.
+     * @return True if tracing was started, false otherwise.
+     */
+    static bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the monotonic time since the tracer was created.
+     * @return The time in nanoseconds.
+     */
+    qint64 now() const;
+
+    /**
+     * @brief Enables tracing.
+     * @param path The file the trace is written to by stop().
+     */
+    void start(const QString &path);
+
+    /**
+     * @brief Disables tracing and writes all recorded spans.
+     * @return True if the trace file was written, false otherwise.
+     */
+    bool stop();
+
+    /**
+     * @brief Records a finished span in the ring buffer of the calling thread, unless tracing was stopped.
+     * @param name The name of the span, must outlive the tracer (a string literal).
+     * @param begin The start time returned by now().
+     * @param end The end time returned by now().
+     */
+    void record(const char *name, qint64 begin, qint64 end);
+
+private:
+    Tracer();
+
+    static constexpr qint32 bufferCapacity = 1 << 16; ///< The number of spans kept per thread.
+
+    /**
+     * @brief A finished span.
+     */
+    struct Event {
+        const char *name; ///< The name of the span.
+        qint64 begin; ///< The start time in nanoseconds.
+        qint64 duration; ///< The duration in nanoseconds.
+    };
+
+    /**
+     * @brief The ring buffer of one thread, only written by its owner.
+     */
+    struct Buffer {
+        QVector<Event> events = QVector<Event>(bufferCapacity); ///< The recorded spans.
+        std::atomic<quint64> head{0}; ///< The number of spans written so far.
+        std::atomic<bool> writing{false}; ///< Whether the owner is recording a span right now.
+        quint64 threadId{}; ///< The id of the owning thread.
+    };
+
+    /**
+     * @brief Returns the ring buffer of the calling thread, registering it on first use.
+     * @return The ring buffer.
+     */
+    Buffer *localBuffer();
+
+    static std::atomic<bool> enabled; ///< Whether spans are recorded.
+
+    QElapsedTimer clock; ///< The monotonic clock all spans are measured with.
+    QString tracePath; ///< The file the trace is written to.
+    QMutex buffersMutex; ///< Guards the registration of new buffers.
+    QVector<Buffer *> buffers; ///< The ring buffers of all threads that recorded spans.
+};
+
+/**
+ * @brief The TraceSpan class records the lifetime of a scope as a span when tracing is enabled.
+ */
+class TraceSpan {
+public:
+    /**
+     * @brief Starts the span.
+     * @param name The name of the span, must be a string literal.
+     */
+    explicit TraceSpan(const char *name)
+            : _name(name), _begin(Tracer::isEnabled() ? Tracer::instance()->now() : -1) {}
+
+    ~TraceSpan() {
+        if (_begin >= 0) {
+            Tracer *tracer = Tracer::instance();
+            tracer->record(_name, _begin, tracer->now());
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *_name; ///< The name of the span.
+    qint64 _begin; ///< The start time, or -1 if tracing is disabled.
+};
+
+#define CC_TRACE_CONCAT_(a, b) a##b
+#define CC_TRACE_CONCAT(a, b) CC_TRACE_CONCAT_(a, b)
+/**
+ * @brief Records the enclosing scope as a span with the given name.
+ */
+#define CC_TRACE_SPAN(name) TraceSpan CC_TRACE_CONCAT(traceSpan, __LINE__)(name)
+
+#endif //CARD_COUNTER_TRACER_HPP
@@ -0,0 +1,328 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <numeric>
+// Qt
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtMath>
+// own
+#include "simulator.hpp"
+#include "src/strategy/strategy.hpp"
+#include "src/strategy/weightmatrix.hpp"
+#include "src/widgets/cards.hpp"
+#include "src/engine/blackjackengine.hpp"
+#include "src/engine/deviationindices.hpp"
+
+namespace {
+    /**
+     * The sums of one chunk of shoes, per strategy.
+     */
+    struct Accumulator {
+        QVector<double> sum;
+        QVector<double> squares;
+        QVector<double> finals;
+        QVector<qint64> trueCountOne;
+        QVector<qint64> trueCountTwo;
+        QVector<qint32> min;
+        QVector<qint32> max;
+        qint64 shoes = 0;
+        qint64 cards = 0;
+    };
+
+    QString csvField(const QString &value) {
+        if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"'))) {
+            return value;
+        }
+        return QLatin1Char('"') + QString(value).replace(QLatin1Char('"'), QStringLiteral("\"\"")) + QLatin1Char('"');
+    }
+}
+
+double Simulator::Report::shoesPerSecond() const {
+    return elapsedNsecs ? shoes * 1e9 / double(elapsedNsecs) : 0;
+}
+
+double Simulator::Report::cardsPerSecond() const {
+    return elapsedNsecs ? cards * 1e9 / double(elapsedNsecs) : 0;
+}
+
+double Simulator::Report::roundsPerSecond() const {
+    return elapsedNsecs ? rounds * 1e9 / double(elapsedNsecs) : 0;
+}
+
+Simulator::Report Simulator::run(const QVector<Strategy *> &strategies, const QVector<qint32> &deckCounts,
+                                 qint32 shoes, quint64 seed) {
+    QElapsedTimer timer;
+    timer.start();
+    Report report;
+    report.seed = seed;
+    report.threads = QThreadPool::globalInstance()->maxThreadCount();
+
+    const WeightMatrix matrix(strategies);
+    const qint32 strategyCount = matrix.strategyCount();
+    const qint32 stride = matrix.stride();
+    const qint32 chunkCount = (shoes + chunkSize - 1) / chunkSize;
+    QVector<qint32> chunks(chunkCount);
+    std::iota(chunks.begin(), chunks.end(), 0);
+
+    for (qint32 deckCount: deckCounts) {
+        QVector<Accumulator> partial(chunkCount);
+        Accumulator *out = partial.data();
+        QtConcurrent::blockingMap(chunks, [&, out, deckCount](qint32 chunk) {
+            const quint32 seedBuffer[] = {quint32(seed), quint32(seed >> 32), quint32(deckCount), quint32(chunk)};
+            QRandomGenerator generator(seedBuffer, 4);
+            Accumulator &accumulator = out[chunk];
+            accumulator.sum.fill(0, strategyCount);
+            accumulator.squares.fill(0, strategyCount);
+            accumulator.finals.fill(0, strategyCount);
+            accumulator.trueCountOne.fill(0, strategyCount);
+            accumulator.trueCountTwo.fill(0, strategyCount);
+            accumulator.min.fill(0, strategyCount);
+            accumulator.max.fill(0, strategyCount);
+            const qint32 end = qMin(shoes, (chunk + 1) * chunkSize);
+            for (qint32 shoe = chunk * chunkSize; shoe < end; shoe++) {
+                const QVector<qint32> cards = Cards::shuffleCards(deckCount, generator).toVector();
+                const QVector<qint32> counts = matrix.trajectories(cards);
+                const qint32 size = cards.size();
+                for (qint32 position = 1; position <= size; position++) {
+                    const qint32 *row = counts.constData() + position * stride;
+                    // the true count is the running count per remaining deck of 54 cards
+                    const qint32 remaining = size - position;
+                    for (qint32 k = 0; k < strategyCount; k++) {
+                        const qint32 count = row[k];
+                        accumulator.sum[k] += count;
+                        accumulator.squares[k] += double(count) * count;
+                        accumulator.min[k] = qMin(accumulator.min[k], count);
+                        accumulator.max[k] = qMax(accumulator.max[k], count);
+                        if (remaining) {
+                            accumulator.trueCountOne[k] += count * 54 >= remaining;
+                            accumulator.trueCountTwo[k] += count * 54 >= 2 * remaining;
+                        }
+                    }
+                }
+                for (qint32 k = 0; k < strategyCount; k++) {
+                    accumulator.finals[k] += counts[size * stride + k];
+                }
+                accumulator.shoes++;
+                accumulator.cards += size;
+            }
+        });
+
+        // merged in chunk order, so the sums do not depend on the scheduling
+        for (qint32 k = 0; k < strategyCount; k++) {
+            Row row;
+            row.strategy = strategies[k]->getName();
+            row.deckCount = deckCount;
+            double sum = 0;
+            double squares = 0;
+            double finals = 0;
+            qint64 trueCountOne = 0;
+            qint64 trueCountTwo = 0;
+            for (const Accumulator &accumulator: qAsConst(partial)) {
+                row.shoes += accumulator.shoes;
+                row.cards += accumulator.cards;
+                sum += accumulator.sum[k];
+                squares += accumulator.squares[k];
+                finals += accumulator.finals[k];
+                trueCountOne += accumulator.trueCountOne[k];
+                trueCountTwo += accumulator.trueCountTwo[k];
+                row.minCount = qMin(row.minCount, accumulator.min[k]);
+                row.maxCount = qMax(row.maxCount, accumulator.max[k]);
+            }
+            if (row.cards) {
+                row.meanCount = sum / row.cards;
+                row.stddevCount = qSqrt(qMax(0.0, squares / row.cards - row.meanCount * row.meanCount));
+                row.finalCount = finals / row.shoes;
+                row.trueCountOne = double(trueCountOne) / row.cards;
+                row.trueCountTwo = double(trueCountTwo) / row.cards;
+            }
+            report.rows.push_back(row);
+        }
+        for (const Accumulator &accumulator: qAsConst(partial)) {
+            report.shoes += accumulator.shoes;
+            report.cards += accumulator.cards;
+        }
+    }
+    report.elapsedNsecs = timer.nsecsElapsed();
+    return report;
+}
+
+Simulator::Report Simulator::playRounds(const QVector<Strategy *> &strategies, const QVector<qint32> &deckCounts,
+                                        qint32 shoes, quint64 seed, const Rules &rules) {
+    QElapsedTimer timer;
+    timer.start();
+    Report report;
+    report.seed = seed;
+    report.threads = QThreadPool::globalInstance()->maxThreadCount();
+
+    const WeightMatrix matrix(strategies);
+    for (qint32 deckCount: deckCounts) {
+        const BlackjackEngine::Result result = BlackjackEngine::simulate(rules, matrix, deckCount, shoes, seed);
+        for (qint32 k = 0; k < strategies.size(); k++) {
+            for (qint32 trueCount = BlackjackEngine::minTrueCount;
+                 trueCount <= BlackjackEngine::maxTrueCount; trueCount++) {
+                const BlackjackEngine::Bucket &bucket = result.bucket(k, trueCount);
+                if (!bucket.rounds) {
+                    continue;
+                }
+                RoundRow row;
+                row.strategy = strategies[k]->getName();
+                row.deckCount = deckCount;
+                row.trueCount = trueCount;
+                row.rounds = bucket.rounds;
+                row.ev = bucket.ev();
+                row.standardError = bucket.standardError();
+                report.roundRows.push_back(row);
+            }
+        }
+        report.shoes += result.shoes;
+        report.rounds += result.rounds;
+    }
+    report.elapsedNsecs = timer.nsecsElapsed();
+    return report;
+}
+
+Simulator::Report Simulator::deviations(const QVector<Strategy *> &strategies, const QVector<qint32> &deckCounts,
+                                        qint64 samples, quint64 seed, const Rules &rules) {
+    QElapsedTimer timer;
+    timer.start();
+    Report report;
+    report.seed = seed;
+    report.threads = QThreadPool::globalInstance()->maxThreadCount();
+
+    for (qint32 deckCount: deckCounts) {
+        for (Strategy *strategy: strategies) {
+            QVector<qint32> weights;
+            for (qint32 rank = 0; rank < 13; rank++) {
+                weights.push_back(strategy->getWeights(rank));
+            }
+            const QVector<DeviationIndices::Entry> entries = DeviationIndices::load(rules, weights, deckCount,
+                                                                                    samples, seed);
+            for (const DeviationIndices::Entry &entry: entries) {
+                DeviationRow row;
+                row.strategy = strategy->getName();
+                row.deckCount = deckCount;
+                row.play = entry.play;
+                row.index = entry.index;
+                row.above = entry.above;
+                row.valid = entry.valid;
+                row.samples = entry.samples;
+                report.deviationRows.push_back(row);
+            }
+        }
+    }
+    report.elapsedNsecs = timer.nsecsElapsed();
+    return report;
+}
+
+QByteArray Simulator::toCsv(const Report &report) {
+    if (!report.deviationRows.isEmpty()) {
+        QString csv = QStringLiteral("strategy,decks,play,index,direction,valid,samples\n");
+        for (const DeviationRow &row: report.deviationRows) {
+            csv += QStringLiteral("%1,%2,%3,%4,%5,%6,%7\n")
+                    .arg(csvField(row.strategy)).arg(row.deckCount).arg(csvField(row.play)).arg(row.index)
+                    .arg(row.above ? QStringLiteral("above") : QStringLiteral("below"))
+                    .arg(row.valid ? 1 : 0).arg(row.samples);
+        }
+        return csv.toUtf8();
+    }
+    if (!report.roundRows.isEmpty()) {
+        QString csv = QStringLiteral("strategy,decks,true_count,rounds,ev,standard_error\n");
+        for (const RoundRow &row: report.roundRows) {
+            csv += QStringLiteral("%1,%2,%3,%4,%5,%6\n")
+                    .arg(csvField(row.strategy)).arg(row.deckCount).arg(row.trueCount).arg(row.rounds)
+                    .arg(row.ev, 0, 'f', 6).arg(row.standardError, 0, 'f', 6);
+        }
+        return csv.toUtf8();
+    }
+    QString csv = QStringLiteral("strategy,decks,shoes,cards,mean_count,stddev_count,min_count,max_count,"
+                                 "final_count,true_count_1,true_count_2\n");
+    for (const Row &row: report.rows) {
+        csv += QStringLiteral("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10,%11\n")
+                .arg(csvField(row.strategy)).arg(row.deckCount).arg(row.shoes).arg(row.cards)
+                .arg(row.meanCount, 0, 'f', 4).arg(row.stddevCount, 0, 'f', 4)
+                .arg(row.minCount).arg(row.maxCount).arg(row.finalCount, 0, 'f', 4)
+                .arg(row.trueCountOne, 0, 'f', 6).arg(row.trueCountTwo, 0, 'f', 6);
+    }
+    return csv.toUtf8();
+}
+
+QByteArray Simulator::toJson(const Report &report) {
+    QJsonArray rows;
+    for (const Row &row: report.rows) {
+        rows.append(QJsonObject{
+                {"strategy",     row.strategy},
+                {"decks",        row.deckCount},
+                {"shoes",        row.shoes},
+                {"cards",        row.cards},
+                {"mean_count",   row.meanCount},
+                {"stddev_count", row.stddevCount},
+                {"min_count",    row.minCount},
+                {"max_count",    row.maxCount},
+                {"final_count",  row.finalCount},
+                {"true_count_1", row.trueCountOne},
+                {"true_count_2", row.trueCountTwo},
+        });
+    }
+    QJsonArray roundRows;
+    for (const RoundRow &row: report.roundRows) {
+        roundRows.append(QJsonObject{
+                {"strategy",       row.strategy},
+                {"decks",          row.deckCount},
+                {"true_count",     row.trueCount},
+                {"rounds",         row.rounds},
+                {"ev",             row.ev},
+                {"standard_error", row.standardError},
+        });
+    }
+    QJsonArray deviationRows;
+    for (const DeviationRow &row: report.deviationRows) {
+        deviationRows.append(QJsonObject{
+                {"strategy",  row.strategy},
+                {"decks",     row.deckCount},
+                {"play",      row.play},
+                {"index",     row.index},
+                {"direction", row.above ? QStringLiteral("above") : QStringLiteral("below")},
+                {"valid",     row.valid},
+                {"samples",   row.samples},
+        });
+    }
+    QJsonObject root{
+            {"seed",              QString::number(report.seed)},
+            {"threads",           report.threads},
+            {"shoes",             report.shoes},
+            {"cards",             report.cards},
+            {"seconds",           report.elapsedNsecs / 1e9},
+            {"shoes_per_second",  report.shoesPerSecond()},
+            {"cards_per_second",  report.cardsPerSecond()},
+            {"rounds",            report.rounds},
+            {"rounds_per_second", report.roundsPerSecond()},
+            {"results",           rows},
+            {"true_counts",       roundRows},
+            {"deviations",        deviationRows},
+    };
+    return QJsonDocument(root).toJson();
+}
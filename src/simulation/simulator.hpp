@@ -0,0 +1,173 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_SIMULATOR_HPP
+#define CARD_COUNTER_SIMULATOR_HPP
+
+// Qt
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+// own
+#include "src/engine/rules.hpp"
+
+class Strategy;
+
+/**
+ * @brief The Simulator class counts many shuffled shoes with a set of strategies, without any display.
+ *
+ * The shoes of every deck count are dealt in fixed chunks on the global thread pool. Every chunk has its own
+ * random generator seeded from the seed, the deck count and the chunk index, and the chunks are merged in
+ * order, so a run is reproducible for a seed whatever the number of threads. All strategies are counted
+ * together in one pass over every shoe with a WeightMatrix.
+ */
+class Simulator {
+public:
+    /**
+     * @brief The running count statistics of one strategy and deck count.
+     */
+    struct Row {
+        QString strategy; ///< The name of the strategy.
+        qint32 deckCount = 0; ///< The number of decks per shoe.
+        qint64 shoes = 0; ///< The number of dealt shoes.
+        qint64 cards = 0; ///< The number of dealt cards.
+        double meanCount = 0; ///< The mean running count over all positions.
+        double stddevCount = 0; ///< The standard deviation of the running count over all positions.
+        qint32 minCount = 0; ///< The smallest running count.
+        qint32 maxCount = 0; ///< The largest running count.
+        double finalCount = 0; ///< The mean running count after the whole shoe, 0 for balanced strategies.
+        double trueCountOne = 0; ///< The fraction of positions with a true count of at least +1.
+        double trueCountTwo = 0; ///< The fraction of positions with a true count of at least +2.
+    };
+
+    /**
+     * @brief The return of basic strategy at one true count of a strategy and deck count.
+     */
+    struct RoundRow {
+        QString strategy; ///< The name of the strategy the true count is computed with.
+        qint32 deckCount = 0; ///< The number of decks per shoe.
+        qint32 trueCount = 0; ///< The true count at the start of the rounds, clamped to the outermost buckets.
+        qint64 rounds = 0; ///< The number of played rounds.
+        double ev = 0; ///< The mean return per round, in initial bets.
+        double standardError = 0; ///< The standard error of ev.
+    };
+
+    /**
+     * @brief The playing deviation index of one play for a strategy and deck count.
+     */
+    struct DeviationRow {
+        QString strategy; ///< The name of the strategy the true count is computed with.
+        qint32 deckCount = 0; ///< The number of decks per shoe.
+        QString play; ///< The name of the play.
+        qint32 index = 0; ///< The true count at which the deviation starts.
+        bool above = true; ///< Whether the deviation is played at or above the index, at or below otherwise.
+        bool valid = false; ///< Whether an index was found within the true count range.
+        qint64 samples = 0; ///< The number of compared hands.
+    };
+
+    /**
+     * @brief The results of a run.
+     */
+    struct Report {
+        QVector<Row> rows; ///< One row per deck count and strategy.
+        QVector<RoundRow> roundRows; ///< One row per deck count, strategy and true count of played rounds.
+        QVector<DeviationRow> deviationRows; ///< One row per deck count, strategy and index play.
+        quint64 seed = 0; ///< The seed of the run.
+        qint32 threads = 0; ///< The number of worker threads.
+        qint64 shoes = 0; ///< The number of dealt shoes over all deck counts.
+        qint64 cards = 0; ///< The number of dealt cards over all deck counts.
+        qint64 rounds = 0; ///< The number of played blackjack rounds over all deck counts.
+        qint64 elapsedNsecs = 0; ///< The wall time of the run.
+
+        /**
+         * @brief Returns the throughput of the run.
+         * @return The dealt and counted shoes per second.
+         */
+        double shoesPerSecond() const;
+
+        /**
+         * @brief Returns the throughput of the run.
+         * @return The dealt and counted cards per second.
+         */
+        double cardsPerSecond() const;
+
+        /**
+         * @brief Returns the throughput of the run.
+         * @return The played blackjack rounds per second.
+         */
+        double roundsPerSecond() const;
+    };
+
+    /**
+     * @brief Deals and counts the given number of shoes for every deck count.
+     * @param strategies The strategies to count with.
+     * @param deckCounts The numbers of decks per shoe, 1 to 10.
+     * @param shoes The number of shoes per deck count.
+     * @param seed The seed of the random generators.
+     * @return The results.
+     */
+    static Report run(const QVector<Strategy *> &strategies, const QVector<qint32> &deckCounts, qint32 shoes,
+                      quint64 seed);
+
+    /**
+     * @brief Plays blackjack rounds with basic strategy from the given number of shoes for every deck count
+     * and books them by the true count of every strategy.
+     * @param strategies The strategies to compute the true counts with.
+     * @param deckCounts The numbers of decks per shoe, 1 to 10.
+     * @param shoes The number of shoes per deck count.
+     * @param seed The seed of the random generators.
+     * @param rules The table rules.
+     * @return The results, in roundRows.
+     */
+    static Report playRounds(const QVector<Strategy *> &strategies, const QVector<qint32> &deckCounts, qint32 shoes,
+                             quint64 seed, const Rules &rules);
+
+    /**
+     * @brief Computes the playing deviation indices of every strategy and deck count, or reads them from
+     * the cache of DeviationIndices.
+     * @param strategies The strategies to compute the indices for.
+     * @param deckCounts The numbers of decks per shoe, 1 to 10.
+     * @param samples The number of compared hands per play.
+     * @param seed The seed of the random generators.
+     * @param rules The table rules.
+     * @return The results, in deviationRows.
+     */
+    static Report deviations(const QVector<Strategy *> &strategies, const QVector<qint32> &deckCounts,
+                             qint64 samples, quint64 seed, const Rules &rules);
+
+    /**
+     * @brief Formats the rows of a report as CSV with a header line, the round or deviation rows if there are any.
+     * @param report The results.
+     * @return The CSV text.
+     */
+    static QByteArray toCsv(const Report &report);
+
+    /**
+     * @brief Formats a report, including the throughput, as a JSON object.
+     * @param report The results.
+     * @return The JSON text.
+     */
+    static QByteArray toJson(const Report &report);
+
+private:
+    static constexpr qint32 chunkSize = 64; ///< The number of shoes dealt from one random generator.
+};
+
+#endif //CARD_COUNTER_SIMULATOR_HPP
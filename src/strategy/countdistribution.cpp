@@ -0,0 +1,220 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <numeric>
+// Qt
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QtMath>
+// own
+#include "countdistribution.hpp"
+#include "src/perf/tracer.hpp"
+
+namespace {
+    const quint32 cacheMagic = 0x43434344; // "CCCD"
+    const quint32 cacheVersion = 1;
+}
+
+CountDistribution CountDistribution::compute(const QVector<qint32> &weights, qint32 deckCount) {
+    CC_TRACE_SPAN("CountDistribution::compute");
+    // the number of cards per weight, the jokers weigh nothing
+    QMap<qint32, qint32> classes;
+    for (qint32 weight: weights) {
+        classes[weight] += 4 * deckCount;
+    }
+    classes[0] += 2 * deckCount;
+
+    const qint32 total = 54 * deckCount;
+    qint32 low = 0;
+    qint32 high = 0;
+    for (auto it = classes.constBegin(); it != classes.constEnd(); ++it) {
+        (it.key() < 0 ? low : high) += it.key() * it.value();
+    }
+    const qint32 width = high - low + 1;
+
+    // ways[t * width + c - low] is the number of ways to draw t cards of the classes processed so far
+    // with the running count c, rowLow/rowHigh bound the non-zero part of every row
+    QVector<double> ways((total + 1) * width, 0.0);
+    QVector<qint32> rowLow(total + 1, width);
+    QVector<qint32> rowHigh(total + 1, -1);
+    ways[-low] = 1;
+    rowLow[0] = rowHigh[0] = -low;
+
+    qint32 drawn = 0;
+    for (auto it = classes.constBegin(); it != classes.constEnd(); ++it) {
+        const qint32 weight = it.key();
+        const qint32 size = it.value();
+        QVector<double> binomials(size + 1);
+        binomials[0] = 1;
+        for (qint32 k = 0; k < size; k++) {
+            binomials[k + 1] = binomials[k] * (size - k) / (k + 1);
+        }
+
+        QVector<double> next((total + 1) * width, 0.0);
+        QVector<qint32> nextLow(total + 1, width);
+        QVector<qint32> nextHigh(total + 1, -1);
+        QVector<qint32> rows(drawn + size + 1);
+        std::iota(rows.begin(), rows.end(), 0);
+
+        const double *in = ways.constData();
+        const double *binomial = binomials.constData();
+        const qint32 *inLow = rowLow.constData();
+        const qint32 *inHigh = rowHigh.constData();
+        double *out = next.data();
+        qint32 *outLow = nextLow.data();
+        qint32 *outHigh = nextHigh.data();
+        // every row of the next table only depends on the current table, so the rows run in parallel
+        QtConcurrent::blockingMap(rows, [=](qint32 t) {
+            double *row = out + t * width;
+            qint32 lo = width;
+            qint32 hi = -1;
+            for (qint32 k = qMax(0, t - drawn); k <= qMin(size, t); k++) {
+                const qint32 source = t - k;
+                if (inHigh[source] < inLow[source]) {
+                    continue;
+                }
+                const double *from = in + source * width;
+                const qint32 shift = weight * k;
+                const double factor = binomial[k];
+                for (qint32 c = inLow[source]; c <= inHigh[source]; c++) {
+                    row[c + shift] += from[c] * factor;
+                }
+                lo = qMin(lo, inLow[source] + shift);
+                hi = qMax(hi, inHigh[source] + shift);
+            }
+            outLow[t] = lo;
+            outHigh[t] = hi;
+        });
+        ways.swap(next);
+        rowLow.swap(nextLow);
+        rowHigh.swap(nextHigh);
+        drawn += size;
+    }
+
+    CountDistribution distribution;
+    distribution.cards = total;
+    double draws = 1; // C(total, t)
+    for (qint32 t = 0; t <= total; t++) {
+        distribution.lowest.push_back(rowLow[t] + low);
+        distribution.starts.push_back(distribution.probabilities.size());
+        for (qint32 c = rowLow[t]; c <= rowHigh[t]; c++) {
+            distribution.probabilities.push_back(ways[t * width + c] / draws);
+        }
+        draws = draws * (total - t) / (t + 1);
+    }
+    distribution.starts.push_back(distribution.probabilities.size());
+    return distribution;
+}
+
+CountDistribution CountDistribution::load(const QVector<qint32> &weights, qint32 deckCount) {
+    const QString path = cachePath(weights, deckCount);
+    CountDistribution distribution = read(path);
+    if (!distribution.isValid()) {
+        distribution = compute(weights, deckCount);
+        distribution.save(path);
+    }
+    return distribution;
+}
+
+bool CountDistribution::isValid() const {
+    return cards > 0;
+}
+
+qint32 CountDistribution::cardCount() const {
+    return cards;
+}
+
+double CountDistribution::probability(qint32 depth, qint32 count) const {
+    qint32 index = starts[depth] + count - lowest[depth];
+    return index >= starts[depth] && index < starts[depth + 1] ? probabilities[index] : 0;
+}
+
+qint32 CountDistribution::percentile(qint32 depth, double fraction) const {
+    double cumulative = 0;
+    for (qint32 i = starts[depth]; i < starts[depth + 1]; i++) {
+        cumulative += probabilities[i];
+        if (cumulative >= fraction) {
+            return lowest[depth] + i - starts[depth];
+        }
+    }
+    return lowest[depth] + starts[depth + 1] - starts[depth] - 1;
+}
+
+double CountDistribution::stddev(qint32 depth) const {
+    double mean = 0;
+    double square = 0;
+    for (qint32 i = starts[depth]; i < starts[depth + 1]; i++) {
+        double count = lowest[depth] + i - starts[depth];
+        mean += probabilities[i] * count;
+        square += probabilities[i] * count * count;
+    }
+    return qSqrt(qMax(0.0, square - mean * mean));
+}
+
+QString CountDistribution::cachePath(const QVector<qint32> &weights, qint32 deckCount) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (qint32 weight: weights) {
+        hash.addData(QByteArray::number(weight) + ',');
+    }
+    hash.addData(QByteArray::number(deckCount));
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           + QStringLiteral("/count-distribution/")
+           + QString::fromLatin1(hash.result().toHex()) + QStringLiteral(".bin");
+}
+
+bool CountDistribution::save(const QString &path) const {
+    CC_TRACE_SPAN("CountDistribution::save");
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream << cacheMagic << cacheVersion << cards << lowest << starts << probabilities;
+    return file.commit();
+}
+
+CountDistribution CountDistribution::read(const QString &path) {
+    CC_TRACE_SPAN("CountDistribution::read");
+    CountDistribution distribution;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return distribution;
+    }
+    QDataStream stream(&file);
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+    if (magic != cacheMagic || version != cacheVersion) {
+        return distribution;
+    }
+    stream >> distribution.cards >> distribution.lowest >> distribution.starts >> distribution.probabilities;
+    if (stream.status() != QDataStream::Ok || distribution.starts.size() != distribution.cards + 2) {
+        return CountDistribution();
+    }
+    return distribution;
+}
@@ -0,0 +1,125 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_COUNTDISTRIBUTION_HPP
+#define CARD_COUNTER_COUNTDISTRIBUTION_HPP
+
+// Qt
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The CountDistribution class holds the exact probability distribution of the running count
+ * after every penetration depth of a freshly shuffled shoe.
+ *
+ * The shoe consists of deckCount decks of 54 cards as produced by Cards::generateDeck, the jokers
+ * count as zero. Since the running count only depends on how many cards of every weight were drawn,
+ * ranks with equal weights are merged into one class and the dynamic programming runs over the drawn
+ * counts per class (a multivariate hypergeometric distribution) instead of over all 14 rank counts.
+ * The rows of the table are computed in parallel and results are cached on disk per weights and deck count.
+ */
+class CountDistribution {
+public:
+    /**
+     * @brief Constructs an empty distribution.
+     */
+    CountDistribution() = default;
+
+    /**
+     * @brief Computes the distribution for the given strategy weights.
+     * @param weights The 13 weights from ace to king.
+     * @param deckCount The number of decks in the shoe, 1 to 10.
+     * @return The distribution.
+     */
+    static CountDistribution compute(const QVector<qint32> &weights, qint32 deckCount);
+
+    /**
+     * @brief Returns the cached distribution, computing and caching it if it is not on disk yet.
+     * @param weights The 13 weights from ace to king.
+     * @param deckCount The number of decks in the shoe, 1 to 10.
+     * @return The distribution.
+     */
+    static CountDistribution load(const QVector<qint32> &weights, qint32 deckCount);
+
+    /**
+     * @brief Checks whether the distribution was computed.
+     * @return True if the distribution is not empty, false otherwise.
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Returns the number of cards in the shoe.
+     * @return The largest penetration depth.
+     */
+    qint32 cardCount() const;
+
+    /**
+     * @brief Returns the probability of a running count after the given number of cards.
+     * @param depth The number of cards drawn, 0 to cardCount().
+     * @param count The running count.
+     * @return The probability in [0, 1].
+     */
+    double probability(qint32 depth, qint32 count) const;
+
+    /**
+     * @brief Returns the smallest running count whose cumulative probability reaches the given fraction.
+     * @param depth The number of cards drawn, 0 to cardCount().
+     * @param fraction The cumulative probability in [0, 1].
+     * @return The running count.
+     */
+    qint32 percentile(qint32 depth, double fraction) const;
+
+    /**
+     * @brief Returns the standard deviation of the running count after the given number of cards.
+     * @param depth The number of cards drawn, 0 to cardCount().
+     * @return The standard deviation.
+     */
+    double stddev(qint32 depth) const;
+
+private:
+    /**
+     * @brief Returns the file the distribution of the given weights is cached in.
+     * @param weights The 13 weights from ace to king.
+     * @param deckCount The number of decks in the shoe.
+     * @return The absolute path of the cache file.
+     */
+    static QString cachePath(const QVector<qint32> &weights, qint32 deckCount);
+
+    /**
+     * @brief Writes the distribution to a cache file.
+     * @param path The file to write.
+     * @return True if the file was written, false otherwise.
+     */
+    bool save(const QString &path) const;
+
+    /**
+     * @brief Reads a distribution from a cache file.
+     * @param path The file to read.
+     * @return The distribution, or an invalid one if the file is missing or broken.
+     */
+    static CountDistribution read(const QString &path);
+
+    qint32 cards = 0; ///< The number of cards in the shoe.
+    QVector<qint32> lowest; ///< The smallest possible running count per depth.
+    QVector<qint32> starts; ///< The index of the first probability of every depth, plus the end.
+    QVector<double> probabilities; ///< The probabilities of the running counts from lowest, for all depths.
+};
+
+#endif //CARD_COUNTER_COUNTDISTRIBUTION_HPP
@@ -22,8 +22,13 @@
 #include <QBoxLayout>
 #include <QTextEdit>
 #include <QSpinBox>
+#include <QJsonArray>
+#include <QJsonObject>
+// KF
+#include <KConfigGroup>
 // own
 #include "strategy.hpp"
+#include "strategycatalog.hpp"
 
 qint32 Strategy::updateWeight(qint32 currentWeight, qint32 rank) {
     return currentWeight + _weights[rank - 1];
@@ -49,3 +54,97 @@ bool Strategy::isCustom() const {
 qint32 Strategy::getWeights(qint32 id) {
     return _weights[id];
 }
+
+void Strategy::save(KConfigGroup &strategiesGroup) {
+    KConfigGroup strategyGroup = strategiesGroup.group(_name);
+    strategyGroup.writeEntry("description", _description);
+    strategyGroup.writeEntry("weights", _weights.toList());
+}
+
+QJsonObject Strategy::toJson() {
+    QJsonArray weights;
+    for (qint32 weight: _weights) {
+        weights.append(weight);
+    }
+    return QJsonObject{
+            {"name",        _name},
+            {"description", _description},
+            {"weights",     weights},
+    };
+}
+
+Strategy *Strategy::fromJson(const QJsonObject &object) {
+    const QString name = object.value(QStringLiteral("name")).toString();
+    const QJsonArray values = object.value(QStringLiteral("weights")).toArray();
+    if (name.isEmpty() || values.size() != 13) {
+        return nullptr;
+    }
+    QVector<qint32> weights;
+    for (const QJsonValue &value: values) {
+        weights.push_back(value.toInt());
+    }
+    return new Strategy(name, object.value(QStringLiteral("description")).toString(), weights, true);
+}
+
+QVector<Strategy *> Strategy::loadStrategies(const KConfigGroup &strategiesGroup) {
+    QVector<Strategy *> strategies;
+    strategies.push_back(new Strategy(
+            "Hi-Opt I Count",
+            "The Hi-Opt I blackjack card counting system was developed by Charles Einstein and introduced in his book "
+            "\"The World's Greatest Blackjack Book\" in 1980. The Hi-Opt I system assigns point values to each card in "
+            "the deck and is a more complex system than the Hi-Lo system, with additional point values for some cards. "
+            "It is considered a more powerful system than the Hi-Lo, but also more difficult to learn "
+            "and use effectively.",
+            {0, 0, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1}));
+
+    strategies.push_back(new Strategy(
+            "Hi-Lo Count",
+            "The Hi-Lo blackjack card counting system was first introduced by Harvey Dubner in 1963. Dubner's goal was "
+            "to create a simple yet effective system that could be used by anyone to increase their odds of winning "
+            "at blackjack.",
+            {-1, 1, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1}));
+
+    strategies.push_back(new Strategy(
+            "Hi-Opt II Count",
+            "The Hi-Opt II blackjack card counting system is a more advanced version of the Hi-Opt I system, "
+            "developed by Lance Humble and Carl Cooper in their book \"The World's Greatest Blackjack Book\" in 1980. "
+            "The Hi-Opt II system assigns point values to each card in the deck, with additional point values "
+            "for some cards, and is considered one of the most powerful card counting systems. It is also one of "
+            "the most difficult to learn and use effectively.",
+            {0, 1, 1, 2, 2, 1, 1, 0, 0, -2, -2, -2, -2}));
+
+    strategies.push_back(new Strategy(
+            "KO Count",
+            "The Knock-Out (KO) blackjack card counting system was developed by Olaf Vancura and Ken Fuchs in their "
+            "book \"Knock-Out Blackjack\" in 1998. The KO system assigns point values to each card in the deck, with "
+            "the additional advantage that it does not require a true count conversion for betting, making it easier "
+            "to use than some other systems.",
+            {-1, 1, 1, 1, 1, 1, 1, 0, 0, -1, -1, -1, -1}));
+
+    strategies.push_back(new Strategy(
+            "Omega II Count",
+            "The Omega II blackjack card counting system was developed by Bryce Carlson and introduced in his book "
+            "\"Blackjack for Blood\" in 2001. The Omega II system assigns point values to each card in the deck, with "
+            "additional point values for some cards, and is considered one of the most powerful card counting systems, "
+            "especially for multi-deck games.",
+            {0, 1, 1, 2, 2, 2, 1, 0, -1, -2, -2, -2, -2}));
+
+    strategies.push_back(new Strategy(
+            "Zen Count",
+            "The Zen Count blackjack card counting system was developed by Arnold Snyder and introduced in his book "
+            "\"Blackbelt in Blackjack\" in 1983. The Zen Count system assigns point values to each card in the deck, "
+            "with additional point values for some cards, and is considered a powerful system for both single "
+            "and multi-deck games.",
+            {-1, 1, 1, 2, 2, 2, 1, 0, 0, -2, -2, -2, -2}));
+
+    strategies.push_back(new Strategy(
+            "10 Count",
+            "The 10 Count blackjack card counting system was developed by Edward O. Thorp, a mathematician and author "
+            "of the classic book \"Beat the Dealer\" in 1962. The 10 Count system assigns point values to each card in "
+            "the deck, with a focus on the 10-value cards, and is considered one of the earliest "
+            "and most basic card counting systems.",
+            {1, 1, 1, 1, 1, 1, 1, 1, 1, -2, -2, -2, -2}));
+
+    strategies.append(StrategyCatalog::load(strategiesGroup));
+    return strategies;
+}
@@ -25,6 +25,10 @@
 #include <QString>
 #include <QVector>
 
+class KConfigGroup;
+
+class QJsonObject;
+
 /**
  * @brief The Strategy class represents a card counting strategy
  */
@@ -72,6 +76,32 @@ public:
      */
     qint32 updateWeight(qint32 currentWeight, qint32 rank);
 
+    /**
+     * @brief save Writes the strategy into its own subgroup of the strategies group
+     * @param strategiesGroup The configuration group containing the list of strategies
+     */
+    void save(KConfigGroup &strategiesGroup);
+
+    /**
+     * @brief toJson Returns the strategy as a JSON object with a name, a description and the weights
+     * @return The JSON object
+     */
+    QJsonObject toJson();
+
+    /**
+     * @brief fromJson Creates a custom strategy from a JSON object written by toJson
+     * @param object The JSON object
+     * @return The strategy, owned by the caller, or nullptr if the object has no name or not 13 weights
+     */
+    static Strategy *fromJson(const QJsonObject &object);
+
+    /**
+     * @brief loadStrategies Creates the built-in strategies followed by the custom ones of the configuration
+     * @param strategiesGroup The configuration group containing the list of strategies
+     * @return The strategies, owned by the caller
+     */
+    static QVector<Strategy *> loadStrategies(const KConfigGroup &strategiesGroup);
+
 private:
     bool _custom; /**< Whether this strategy is custom or not */
     QVector<qint32> _weights; /**< A vector of weights, where the index is the card rank */
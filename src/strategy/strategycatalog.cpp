@@ -0,0 +1,172 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <cstring>
+// Qt
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+// KF
+#include <KConfig>
+#include <KConfigGroup>
+// own
+#include "strategycatalog.hpp"
+#include "strategy.hpp"
+#include "src/perf/tracer.hpp"
+
+namespace {
+    const quint32 catalogMagic = 0x43435343; // "CCSC"
+    const quint32 catalogVersion = 2;
+    // the key of the generation in the CCStrategies group, next to the groups of the strategies
+    const char generationKey[] = "generation";
+
+    /**
+     * Returns the rc file the group is read from.
+     */
+    QFileInfo configFile(const KConfigGroup &strategiesGroup) {
+        const QString name = strategiesGroup.config()->name();
+        return QFileInfo(QDir::isAbsolutePath(name) ? name
+                                                    : QStandardPaths::writableLocation(
+                        QStandardPaths::GenericConfigLocation) + QLatin1Char('/') + name);
+    }
+}
+
+QVector<Strategy *> StrategyCatalog::load(const KConfigGroup &strategiesGroup) {
+    CC_TRACE_SPAN("StrategyCatalog::load");
+    const QFileInfo config = configFile(strategiesGroup);
+    if (!config.exists()) {
+        return parse(strategiesGroup);
+    }
+    const qint64 modified = config.lastModified().toMSecsSinceEpoch();
+    const qint64 size = config.size();
+    const qint64 generation = strategiesGroup.readEntry(generationKey, qint64(0));
+    const QString path = cachePath(strategiesGroup);
+    QVector<Strategy *> strategies;
+    if (read(path, modified, size, generation, strategies)) {
+        return strategies;
+    }
+    strategies = parse(strategiesGroup);
+    write(path, modified, size, generation, strategies);
+    return strategies;
+}
+
+QString StrategyCatalog::cachePath(const KConfigGroup &strategiesGroup) {
+    const QFileInfo config = configFile(strategiesGroup);
+    // rc files of the same name in other directories, e.g. of a benchmark, get catalogs of their own
+    const QByteArray key = QCryptographicHash::hash(config.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1)
+            .toHex().left(16);
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           + QStringLiteral("/%1-%2.catalog").arg(config.fileName(), QString::fromLatin1(key));
+}
+
+void StrategyCatalog::bumpGeneration(KConfigGroup &strategiesGroup) {
+    strategiesGroup.writeEntry(generationKey, strategiesGroup.readEntry(generationKey, qint64(0)) + 1);
+}
+
+bool StrategyCatalog::read(const QString &path, qint64 modified, qint64 size, qint64 generation,
+                           QVector<Strategy *> &strategies) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(Header))) {
+        return false;
+    }
+    const uchar *data = file.map(0, file.size());
+    if (!data) {
+        return false;
+    }
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+    const qint64 expected = qint64(sizeof(Header)) + qint64(header.count) * qint64(sizeof(Record))
+                            + qint64(header.characters) * qint64(sizeof(char16_t));
+    if (header.magic != catalogMagic || header.version != catalogVersion
+        || header.modified != modified || header.size != size || header.generation != generation
+        || expected != file.size()) {
+        return false;
+    }
+    const auto *records = reinterpret_cast<const Record *>(data + sizeof(Header));
+    const auto *characters = reinterpret_cast<const QChar *>(records + header.count);
+    strategies.reserve(qint32(header.count));
+    for (quint32 i = 0; i < header.count; i++) {
+        const Record &record = records[i];
+        if (quint64(record.name) + record.nameLength > header.characters
+            || quint64(record.description) + record.descriptionLength > header.characters) {
+            qDeleteAll(strategies);
+            strategies.clear();
+            return false;
+        }
+        strategies.push_back(new Strategy(
+                QString(characters + record.name, qint32(record.nameLength)),
+                QString(characters + record.description, qint32(record.descriptionLength)),
+                QVector<qint32>(record.weights, record.weights + 13), true));
+    }
+    return true;
+}
+
+bool StrategyCatalog::write(const QString &path, qint64 modified, qint64 size, qint64 generation,
+                            const QVector<Strategy *> &strategies) {
+    CC_TRACE_SPAN("StrategyCatalog::write");
+    QVector<Record> records;
+    QString characters;
+    for (Strategy *strategy: strategies) {
+        Record record{};
+        const QString name = strategy->getName();
+        const QString description = strategy->getDescription();
+        record.name = quint32(characters.size());
+        record.nameLength = quint32(name.size());
+        characters += name;
+        record.description = quint32(characters.size());
+        record.descriptionLength = quint32(description.size());
+        characters += description;
+        for (qint32 rank = 0; rank < 13; rank++) {
+            record.weights[rank] = strategy->getWeights(rank);
+        }
+        records.push_back(record);
+    }
+    const Header header{catalogMagic, catalogVersion, modified, size, generation, quint32(records.size()),
+                        quint32(characters.size())};
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char *>(records.constData()), qint64(records.size()) * qint64(sizeof(Record)));
+    file.write(reinterpret_cast<const char *>(characters.constData()),
+               qint64(characters.size()) * qint64(sizeof(QChar)));
+    return file.commit();
+}
+
+QVector<Strategy *> StrategyCatalog::parse(const KConfigGroup &strategiesGroup) {
+    CC_TRACE_SPAN("Strategy::readConfig");
+    QVector<Strategy *> strategies;
+    const QStringList strategyNames = strategiesGroup.groupList();
+    for (const auto &strategyName: strategyNames) {
+        KConfigGroup strategyGroup = strategiesGroup.group(strategyName);
+        QVector<qint32> weights = QVector<int>::fromList(strategyGroup.readEntry("weights", QList<int>()));
+        // the records hold exactly 13 weights
+        weights.resize(13);
+        strategies.push_back(new Strategy(strategyName, strategyGroup.readEntry("description", ""), weights, true));
+    }
+    return strategies;
+}
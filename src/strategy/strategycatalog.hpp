@@ -0,0 +1,122 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_STRATEGYCATALOG_HPP
+#define CARD_COUNTER_STRATEGYCATALOG_HPP
+
+// Qt
+#include <QString>
+#include <QVector>
+
+class Strategy;
+
+class KConfigGroup;
+
+/**
+ * @brief The StrategyCatalog class caches the custom strategies of the configuration in a binary file that is
+ * memory-mapped on load.
+ *
+ * The CCStrategies group stays the source of truth. Every rc file has its own catalog, which records the generation
+ * of the group and the modification time and size of the rc file it was built from. Every write of the group bumps
+ * the generation, so an edit is noticed even if it neither changes the size nor the timestamp of the file. When any
+ * of them no longer matches, the strategies are read from the group as before and the catalog is rebuilt. Otherwise the file holds a fixed-size record per strategy with the 13 weights as integers
+ * and the offsets of its name and description in a UTF-16 string area, so loading N strategies is one pass over
+ * the records without any per-entry text parsing.
+ */
+class StrategyCatalog {
+public:
+    /**
+     * @brief Returns the custom strategies of the configuration, from the catalog if it is up to date.
+     * @param strategiesGroup The configuration group containing the list of strategies.
+     * @return The strategies in the order of the group, owned by the caller.
+     */
+    static QVector<Strategy *> load(const KConfigGroup &strategiesGroup);
+
+    /**
+     * @brief Returns the catalog file of a configuration.
+     * @param strategiesGroup The configuration group containing the list of strategies.
+     * @return The absolute path of the catalog.
+     */
+    static QString cachePath(const KConfigGroup &strategiesGroup);
+
+    /**
+     * @brief Bumps the generation of the strategies, to be called by every writer of the group before it syncs.
+     * @param strategiesGroup The configuration group containing the list of strategies.
+     */
+    static void bumpGeneration(KConfigGroup &strategiesGroup);
+
+private:
+    /**
+     * @brief The start of the catalog file.
+     */
+    struct Header {
+        quint32 magic; ///< Identifies the file as a catalog.
+        quint32 version; ///< The layout version.
+        qint64 modified; ///< The modification time of the rc file in milliseconds since the epoch.
+        qint64 size; ///< The size of the rc file.
+        qint64 generation; ///< The generation of the group.
+        quint32 count; ///< The number of records.
+        quint32 characters; ///< The number of UTF-16 code units in the string area.
+    };
+
+    /**
+     * @brief One strategy, the records follow the header and the string area follows the records.
+     */
+    struct Record {
+        quint32 name; ///< The offset of the name in the string area.
+        quint32 nameLength; ///< The length of the name.
+        quint32 description; ///< The offset of the description in the string area.
+        quint32 descriptionLength; ///< The length of the description.
+        qint32 weights[13]; ///< The weights from ace to king.
+    };
+
+    /**
+     * @brief Maps a catalog and creates its strategies.
+     * @param path The catalog file.
+     * @param modified The modification time the rc file must have.
+     * @param size The size the rc file must have.
+     * @param generation The generation the group must have.
+     * @param strategies Receives the strategies.
+     * @return True if the catalog was valid and up to date, false otherwise.
+     */
+    static bool read(const QString &path, qint64 modified, qint64 size, qint64 generation,
+                     QVector<Strategy *> &strategies);
+
+    /**
+     * @brief Writes a catalog.
+     * @param path The catalog file.
+     * @param modified The modification time of the rc file the strategies were read from.
+     * @param size The size of that rc file.
+     * @param generation The generation of the group.
+     * @param strategies The strategies.
+     * @return True if the file was written, false otherwise.
+     */
+    static bool write(const QString &path, qint64 modified, qint64 size, qint64 generation,
+                      const QVector<Strategy *> &strategies);
+
+    /**
+     * @brief Reads the strategies from the text entries of the configuration group.
+     * @param strategiesGroup The configuration group containing the list of strategies.
+     * @return The strategies, owned by the caller.
+     */
+    static QVector<Strategy *> parse(const KConfigGroup &strategiesGroup);
+};
+
+#endif //CARD_COUNTER_STRATEGYCATALOG_HPP
@@ -0,0 +1,337 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <algorithm>
+#include <iterator>
+// Qt
+#include <QPair>
+#include <QStringList>
+// own
+#include "strategyindex.hpp"
+#include "strategy.hpp"
+
+namespace {
+    // the strategies are only renumbered once the index is this large, small ones never need it
+    const qint32 compactMinimum = 64;
+
+    /**
+     * @brief Removes duplicates from n-gram keys.
+     * @param keys The keys, sorted afterwards.
+     */
+    void unique(QVector<quint64> &keys) {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+}
+
+bool StrategyIndex::Predicate::matches(qint32 weight) const {
+    switch (comparison) {
+        case Equal:
+            return weight == value;
+        case NotEqual:
+            return weight != value;
+        case Less:
+            return weight < value;
+        case LessEqual:
+            return weight <= value;
+        case Greater:
+            return weight > value;
+        case GreaterEqual:
+            return weight >= value;
+    }
+    return false;
+}
+
+void StrategyIndex::insert(Strategy *strategy) {
+    if (ids.contains(strategy)) {
+        return;
+    }
+    const qint32 id = strategies.size();
+    strategies.push_back(strategy);
+    names.push_back(strategy->getName().toLower());
+    descriptions.push_back(strategy->getDescription().toLower());
+    for (qint32 rank = 0; rank < 13; rank++) {
+        columns[rank].push_back(strategy->getWeights(rank));
+    }
+    ids.insert(strategy, id);
+    post(id);
+}
+
+void StrategyIndex::remove(Strategy *strategy) {
+    const auto it = ids.find(strategy);
+    if (it == ids.end()) {
+        return;
+    }
+    // the id stays in the posting lists until they are rebuilt, searches skip it
+    const qint32 id = it.value();
+    strategies[id] = nullptr;
+    names[id].clear();
+    descriptions[id].clear();
+    ids.erase(it);
+    removed++;
+    if (strategies.size() >= compactMinimum && 2 * removed > strategies.size()) {
+        compact();
+    }
+}
+
+void StrategyIndex::clear() {
+    strategies.clear();
+    names.clear();
+    descriptions.clear();
+    for (QVector<qint32> &column: columns) {
+        column.clear();
+    }
+    ids.clear();
+    namePostings.clear();
+    descriptionPostings.clear();
+    removed = 0;
+}
+
+QVector<StrategyIndex::Match> StrategyIndex::search(const QString &query) const {
+    QVector<Predicate> predicates;
+    QStringList words;
+    for (const QString &word: query.toLower().split(QLatin1Char(' '), Qt::SkipEmptyParts)) {
+        Predicate predicate{};
+        if (parsePredicate(word, predicate)) {
+            predicates.push_back(predicate);
+        } else {
+            words.push_back(word);
+        }
+    }
+
+    // the longest word has the most n-grams and usually the fewest candidates, the others are confirmed
+    QString longest;
+    for (const QString &word: words) {
+        if (word.size() > longest.size()) {
+            longest = word;
+        }
+    }
+    QVector<qint32> named;
+    QVector<qint32> described;
+    QVector<qint32> candidates;
+    if (words.isEmpty()) {
+        // weights are not indexed, their columns are scanned faster than lists could be merged
+        candidates.reserve(strategies.size());
+        for (qint32 id = 0; id < strategies.size(); id++) {
+            candidates.push_back(id);
+        }
+    } else {
+        named = StrategyIndex::candidates(namePostings, longest, qMin(longest.size(), qint32(3)));
+        if (longest.size() >= 3) {
+            described = StrategyIndex::candidates(descriptionPostings, longest, 3);
+        }
+        candidates.reserve(named.size() + described.size());
+        std::set_union(named.begin(), named.end(), described.begin(), described.end(),
+                       std::back_inserter(candidates));
+    }
+
+    // every predicate narrows the candidates in one pass over the column of its rank
+    for (const Predicate &predicate: qAsConst(predicates)) {
+        const qint32 *column = columns[predicate.rank].constData();
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](qint32 id) {
+            return !predicate.matches(column[id]);
+        }), candidates.end());
+    }
+
+    QVector<Match> matches;
+    for (qint32 id: candidates) {
+        if (!strategies[id]) {
+            continue;
+        }
+        bool accepted = true;
+        qint32 score = 0;
+        for (qint32 i = 0; accepted && i < words.size(); i++) {
+            const QString &word = words[i];
+            const QString &name = names[id];
+            if (name.startsWith(word)) {
+                score += 3;
+            } else if (name.contains(word)) {
+                score += 2;
+            } else if (word.size() < 3) {
+                // short words are only looked up in the names
+                accepted = false;
+            } else if (word.size() == 3 && word == longest) {
+                // a single trigram is matched exactly by its posting list
+                accepted = std::binary_search(described.begin(), described.end(), id);
+                score += 1;
+            } else if (descriptions[id].contains(word)) {
+                score += 1;
+            } else {
+                accepted = false;
+            }
+        }
+        if (accepted) {
+            matches.push_back({strategies[id], score});
+        }
+    }
+    // candidates are in id order, so equal scores keep the order the strategies were added in
+    std::stable_sort(matches.begin(), matches.end(), [](const Match &a, const Match &b) {
+        return a.score > b.score;
+    });
+    return matches;
+}
+
+bool StrategyIndex::parsePredicate(const QString &word, Predicate &predicate) {
+    // the two-character comparisons first, so "<=" is not read as "<"
+    static const QVector<QPair<QString, Comparison>> comparisons = {
+            {QStringLiteral("!="), NotEqual},
+            {QStringLiteral("<="), LessEqual},
+            {QStringLiteral(">="), GreaterEqual},
+            {QStringLiteral("="),  Equal},
+            {QStringLiteral("<"),  Less},
+            {QStringLiteral(">"),  Greater}
+    };
+    static const QHash<QString, qint32> ranks = {
+            {QStringLiteral("a"),     0},
+            {QStringLiteral("ace"),   0},
+            {QStringLiteral("two"),   1},
+            {QStringLiteral("three"), 2},
+            {QStringLiteral("four"),  3},
+            {QStringLiteral("five"),  4},
+            {QStringLiteral("six"),   5},
+            {QStringLiteral("seven"), 6},
+            {QStringLiteral("eight"), 7},
+            {QStringLiteral("nine"),  8},
+            {QStringLiteral("ten"),   9},
+            {QStringLiteral("t"),     9},
+            {QStringLiteral("j"),     10},
+            {QStringLiteral("jack"),  10},
+            {QStringLiteral("q"),     11},
+            {QStringLiteral("queen"), 11},
+            {QStringLiteral("k"),     12},
+            {QStringLiteral("king"),  12}
+    };
+    for (const auto &comparison: comparisons) {
+        const qint32 at = word.indexOf(comparison.first);
+        if (at <= 0) {
+            continue;
+        }
+        const QString rank = word.left(at);
+        bool valid = false;
+        const qint32 value = word.mid(at + comparison.first.size()).toInt(&valid);
+        if (!valid) {
+            return false;
+        }
+        bool numeric = false;
+        const qint32 number = rank.toInt(&numeric);
+        if (numeric && number >= 2 && number <= 10) {
+            predicate.rank = number - 1;
+        } else if (ranks.contains(rank)) {
+            predicate.rank = ranks.value(rank);
+        } else {
+            return false;
+        }
+        predicate.comparison = comparison.second;
+        predicate.value = value;
+        return true;
+    }
+    return false;
+}
+
+quint64 StrategyIndex::gram(const QString &text, qint32 position, qint32 length) {
+    quint64 key = quint64(length) << 48;
+    for (qint32 i = 0; i < length; i++) {
+        key |= quint64(text[position + i].unicode()) << (32 - 16 * i);
+    }
+    return key;
+}
+
+QVector<qint32> StrategyIndex::candidates(const QHash<quint64, QVector<qint32>> &postings, const QString &word,
+                                          qint32 length) {
+    QVector<const QVector<qint32> *> lists;
+    for (qint32 position = 0; position + length <= word.size(); position++) {
+        const auto it = postings.constFind(gram(word, position, length));
+        if (it == postings.constEnd()) {
+            return {};
+        }
+        lists.push_back(&it.value());
+    }
+    if (lists.isEmpty()) {
+        return {};
+    }
+    std::sort(lists.begin(), lists.end(), [](const QVector<qint32> *a, const QVector<qint32> *b) {
+        return a->size() < b->size();
+    });
+    // the shortest list bounds the result, much longer ones are only probed instead of walked through
+    QVector<qint32> result = *lists.first();
+    QVector<qint32> merged;
+    for (qint32 i = 1; i < lists.size() && !result.isEmpty(); i++) {
+        const QVector<qint32> &list = *lists[i];
+        if (list.size() / 16 > result.size()) {
+            result.erase(std::remove_if(result.begin(), result.end(), [&list](qint32 id) {
+                return !std::binary_search(list.begin(), list.end(), id);
+            }), result.end());
+        } else {
+            merged.clear();
+            std::set_intersection(result.begin(), result.end(), list.begin(), list.end(),
+                                  std::back_inserter(merged));
+            result.swap(merged);
+        }
+    }
+    return result;
+}
+
+void StrategyIndex::compact() {
+    const QVector<Strategy *> kept = strategies;
+    const QVector<QString> keptNames = names;
+    const QVector<QString> keptDescriptions = descriptions;
+    QVector<qint32> keptColumns[13];
+    std::copy(std::begin(columns), std::end(columns), std::begin(keptColumns));
+    clear();
+    for (qint32 id = 0; id < kept.size(); id++) {
+        if (!kept[id]) {
+            continue;
+        }
+        ids.insert(kept[id], strategies.size());
+        strategies.push_back(kept[id]);
+        names.push_back(keptNames[id]);
+        descriptions.push_back(keptDescriptions[id]);
+        for (qint32 rank = 0; rank < 13; rank++) {
+            columns[rank].push_back(keptColumns[rank][id]);
+        }
+        post(strategies.size() - 1);
+    }
+}
+
+void StrategyIndex::post(qint32 id) {
+    // ids only grow, so appending keeps every posting list sorted
+    const QString &name = names[id];
+    QVector<quint64> keys;
+    for (qint32 length = 1; length <= 3; length++) {
+        for (qint32 position = 0; position + length <= name.size(); position++) {
+            keys.push_back(gram(name, position, length));
+        }
+    }
+    unique(keys);
+    for (quint64 key: keys) {
+        namePostings[key].push_back(id);
+    }
+
+    const QString &description = descriptions[id];
+    keys.clear();
+    for (qint32 position = 0; position + 3 <= description.size(); position++) {
+        keys.push_back(gram(description, position, 3));
+    }
+    unique(keys);
+    for (quint64 key: keys) {
+        descriptionPostings[key].push_back(id);
+    }
+}
@@ -0,0 +1,159 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_STRATEGYINDEX_HPP
+#define CARD_COUNTER_STRATEGYINDEX_HPP
+
+// Qt
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class Strategy;
+
+/**
+ * @brief The StrategyIndex class answers search queries over the names, descriptions and weights of strategies.
+ *
+ * A query is a list of words separated by spaces, all of which must match. A word like "ace=-1", "5>=2" or
+ * "k!=0" compares the weight of a rank (a/ace, 2-10 or two-ten, t, j/jack, q/queen, k/king) with =, !=, <, <=, >
+ * or >=; any other word must appear in the name or, if it has three characters or more, the Markdown description,
+ * ignoring the case.
+ *
+ * Every strategy gets an id in the order it was added, and the posting lists of the 1-, 2- and 3-grams of the names
+ * and the 3-grams of the descriptions hold those ids in ascending order, so the candidates of a word are the
+ * intersection of the lists of its n-grams, which only need to be confirmed for the rare false positives. Replacing
+ * a strategy removes its id and adds a new one; the lists are rebuilt once half of their ids are removed ones.
+ * Matches are ranked by where the words were found: a name starting with a word first, then names containing it,
+ * then descriptions.
+ */
+class StrategyIndex {
+public:
+    /**
+     * @brief A strategy matching a query.
+     */
+    struct Match {
+        Strategy *strategy; ///< The strategy.
+        qint32 score; ///< The higher, the better the match.
+    };
+
+    /**
+     * @brief Adds a strategy.
+     * @param strategy The strategy, it must stay alive while it is indexed.
+     */
+    void insert(Strategy *strategy);
+
+    /**
+     * @brief Removes a strategy.
+     * @param strategy The strategy.
+     */
+    void remove(Strategy *strategy);
+
+    /**
+     * @brief Removes all strategies.
+     */
+    void clear();
+
+    /**
+     * @brief Finds the strategies matching a query.
+     * @param query The query.
+     * @return The matches, the best first, or all strategies with a score of 0 if the query is blank.
+     */
+    QVector<Match> search(const QString &query) const;
+
+private:
+    /**
+     * @brief The comparisons of a weight.
+     */
+    enum Comparison {
+        Equal, /**< = */
+        NotEqual, /**< != */
+        Less, /**< < */
+        LessEqual, /**< <= */
+        Greater, /**< > */
+        GreaterEqual /**< >= */
+    };
+
+    /**
+     * @brief A comparison of the weight of a rank.
+     */
+    struct Predicate {
+        qint32 rank; ///< The rank from 0 for the ace to 12 for the king.
+        Comparison comparison; ///< How the weight is compared.
+        qint32 value; ///< The weight compared with.
+
+        /**
+         * @brief Checks the weight of the rank of a strategy.
+         * @param weight The weight of the rank.
+         * @return True if the weight satisfies the comparison, false otherwise.
+         */
+        bool matches(qint32 weight) const;
+    };
+
+    /**
+     * @brief Parses a word as a weight comparison.
+     * @param word The word in lower case.
+     * @param predicate Receives the comparison.
+     * @return True if the word is a weight comparison, false otherwise.
+     */
+    static bool parsePredicate(const QString &word, Predicate &predicate);
+
+    /**
+     * @brief Packs n consecutive characters into one key.
+     * @param text The text.
+     * @param position The first character.
+     * @param length The number of characters, 1 to 3.
+     * @return The key.
+     */
+    static quint64 gram(const QString &text, qint32 position, qint32 length);
+
+    /**
+     * @brief Returns the ids of the strategies whose text contains all n-grams of a word.
+     * @param postings The posting lists.
+     * @param word The word in lower case.
+     * @param length The n of the n-grams.
+     * @return The ids in ascending order, removed ones included.
+     */
+    static QVector<qint32> candidates(const QHash<quint64, QVector<qint32>> &postings, const QString &word,
+                                      qint32 length);
+
+    /**
+     * @brief Renumbers the strategies that are not removed and rebuilds the posting lists.
+     */
+    void compact();
+
+    /**
+     * @brief Adds the n-grams of a strategy to the posting lists.
+     * @param id The id of the strategy.
+     */
+    void post(qint32 id);
+
+    // the strategies are stored column by column, with one column per rank, so a weight predicate scans only
+    // the weights of its rank
+    QVector<Strategy *> strategies; ///< The strategy of every id, nullptr once removed.
+    QVector<QString> names; ///< The name of every id in lower case.
+    QVector<QString> descriptions; ///< The description of every id in lower case.
+    QVector<qint32> columns[13]; ///< The weight of every id, one column per rank from ace to king.
+    QHash<Strategy *, qint32> ids; ///< The id of every indexed strategy.
+    QHash<quint64, QVector<qint32>> namePostings; ///< The ids per 1-, 2- and 3-gram of the names.
+    QHash<quint64, QVector<qint32>> descriptionPostings; ///< The ids per 3-gram of the descriptions.
+    qint32 removed = 0; ///< The number of removed strategies.
+};
+
+#endif //CARD_COUNTER_STRATEGYINDEX_HPP
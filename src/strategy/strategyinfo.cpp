@@ -26,9 +26,14 @@
 #include <QSpinBox>
 #include <QSvgRenderer>
 #include <QDialogButtonBox>
-#include <QListWidget>
+#include <QListView>
 #include <QLineEdit>
 #include <QTextEdit>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QTimer>
+#include <QtConcurrent>
 // KF
 #include <KLocalizedString>
 #include <KConfigGroup>
@@ -36,8 +41,29 @@
 // own
 #include "strategyinfo.hpp"
 #include "strategy.hpp"
-#include "src/widgets/carousel.hpp"
-#include "src/widgets/cards.hpp"
+#include "strategyoptimizer.hpp"
+#include "strategystore.hpp"
+#include "strategytransfer.hpp"
+#include "strategymodel.hpp"
+#include "weightmatrix.hpp"
+#include "src/widgets/rankstrip.hpp"
+#include "src/widgets/markdownpreview.hpp"
+#include "src/perf/tracer.hpp"
+
+namespace {
+    /**
+     * @brief Returns all weights of a strategy.
+     * @param strategy The strategy.
+     * @return The 13 weights from ace to king.
+     */
+    QVector<qint32> weightsOf(Strategy *strategy) {
+        QVector<qint32> weights;
+        for (qint32 rank = 0; rank < 13; rank++) {
+            weights.push_back(strategy->getWeights(rank));
+        }
+        return weights;
+    }
+}
 
 StrategyInfo::StrategyInfo(QSvgRenderer *renderer, QWidget *parent, Qt::WindowFlags flags)
         : QDialog(parent, flags), m_renderer(renderer), _id(0) {
@@ -45,6 +71,8 @@ StrategyInfo::StrategyInfo(QSvgRenderer *renderer, QWidget *parent, Qt::WindowFl
     setModal(true);
 
     strategiesGroup = new KConfigGroup(KSharedConfig::openConfig(), "CCStrategies");
+    // replays the edits a crash left in the journal before the strategies are read
+    store = new StrategyStore(strategiesGroup, this);
 
     initStrategies();
 
@@ -54,14 +82,17 @@ StrategyInfo::StrategyInfo(QSvgRenderer *renderer, QWidget *parent, Qt::WindowFl
     auto *leftPanel = new QWidget;
     auto *leftPanelLayout = new QVBoxLayout(leftPanel);
     auto *searchBox = new QLineEdit();
-    listWidget = new QListWidget();
+    listView = new QListView();
     auto *rightPanel = new QWidget;
     auto *body = new QVBoxLayout(rightPanel);
-    auto *carousel = new Carousel(renderer->boundsOnElement("back").size());
-    _name = new QLabel(items[_id]->getName());
-    _description = new QLabel(items[_id]->getDescription());
+    _name = new QLabel(model->strategy(_id)->getName());
+    _description = new MarkdownPreview();
+    _description->setMarkdown(model->strategy(_id)->getName(), model->strategy(_id)->getDescription());
     _nameInput = new QLineEdit();
     _descriptionInput = new QTextEdit();
+    descriptionTimer = new QTimer(this);
+    descriptionTimer->setSingleShot(true);
+    descriptionTimer->setInterval(200);
     auto *title = new QWidget;
     auto *titleLayout = new QHBoxLayout(title);
     auto *browser = new QWidget;
@@ -69,12 +100,13 @@ StrategyInfo::StrategyInfo(QSvgRenderer *renderer, QWidget *parent, Qt::WindowFl
 
     leftPanel->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Minimum);
     searchBox->setPlaceholderText(tr("Search"));
-    listWidget->setSelectionMode(QAbstractItemView::SingleSelection);
-    listWidget->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    listWidget->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
-    _description->setWordWrap(true);
-    _description->setTextFormat(Qt::TextFormat::MarkdownText);
-    _description->setOpenExternalLinks(true);
+    searchBox->setToolTip(tr("Words to find in the names and descriptions, or weights like \"ace=-1\" or \"5>=2\"."));
+    listView->setModel(listModel);
+    listView->setSelectionMode(QAbstractItemView::SingleSelection);
+    listView->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    listView->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
+    // all rows have the same height, so the view does not measure them one by one
+    listView->setUniformItemSizes(true);
     _name->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
     _nameInput->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
     _description->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
@@ -87,192 +119,417 @@ StrategyInfo::StrategyInfo(QSvgRenderer *renderer, QWidget *parent, Qt::WindowFl
     titleLayout->addWidget(_name);
     browserLayout->addWidget(_descriptionInput);
     browserLayout->addWidget(_description);
-    leftPanelLayout->addWidget(listWidget);
+    leftPanelLayout->addWidget(listView);
+
+    optimizer = new StrategyOptimizer(this);
+    optimizerWatcher = new QFutureWatcher<void>(this);
+    optimizeMetric = new QComboBox();
+    optimizeMetric->addItems({i18n("Betting correlation"), i18n("Playing efficiency"),
+                              i18n("Insurance correlation")});
+    optimizeLevel = new QSpinBox();
+    optimizeLevel->setRange(1, 5);
+    optimizeLevel->setValue(2);
+    optimizeBalanced = new QCheckBox(i18n("Balanced"));
+    optimizeBalanced->setChecked(true);
+    optimizeButton = new QPushButton(QIcon::fromTheme("run-build"), i18n("&Optimize"));
+    auto *optimize = new QFormLayout();
+    optimize->addRow(i18n("Maximize:"), optimizeMetric);
+    optimize->addRow(i18n("Max Level:"), optimizeLevel);
+    optimize->addRow(optimizeBalanced);
+    optimize->addRow(optimizeButton);
+    leftPanelLayout->addLayout(optimize);
+    transfer = new StrategyTransfer(this);
+    importButton = new QPushButton(QIcon::fromTheme("document-import"), i18n("&Import…"));
+    exportButton = new QPushButton(QIcon::fromTheme("document-export"), i18n("&Export…"));
+    transferLabel = new QLabel();
+    transferLabel->setWordWrap(true);
+    auto *transferLayout = new QHBoxLayout();
+    transferLayout->addWidget(importButton);
+    transferLayout->addWidget(exportButton);
+    leftPanelLayout->addLayout(transferLayout);
+    leftPanelLayout->addWidget(transferLabel);
     window->addWidget(leftPanel);
     window->addWidget(rightPanel);
     body->addWidget(title);
     body->addWidget(browser);
-    for (int i = Cards::Rank::Ace; i <= Cards::Rank::King; i++) {
-        auto *card = new Cards(renderer);
-        auto *form = new QFormLayout(card);
-        auto *spin = new QSpinBox();
-
-        card->setId(i);
-        spin->setRange(-5, 5);
-        spin->setValue(items[_id]->getWeights(i - Cards::Rank::Ace));
-        spin->setReadOnly(!items[_id]->isCustom());
-        spin->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
-        form->setFormAlignment(Qt::AlignCenter);
-        form->addRow(spin);
-        carousel->addWidget(card);
-        weights.push_back(spin);
-    }
-    body->addWidget(carousel);
+    rankStrip = new RankStrip(renderer);
+    rankStrip->setRange(-5, 5);
+    rankStrip->setWeights(weightsOf(model->strategy(_id)));
+    rankStrip->setReadOnly(!model->strategy(_id)->isCustom());
+    connect(rankStrip, &RankStrip::weightsChanged, this, &StrategyInfo::updateMetrics);
+    body->addWidget(rankStrip);
+
+    metricsLabel = new QLabel();
+    metricsLabel->setWordWrap(true);
+    body->addWidget(metricsLabel);
+
+    auto *distribution = new QFormLayout();
+    distributionDecks = new QSpinBox();
+    distributionDecks->setRange(1, 10);
+    distributionLabel = new QLabel();
+    distributionLabel->setWordWrap(true);
+    distributionWatcher = new QFutureWatcher<CountDistribution>(this);
+    distribution->addRow(i18n("Number of Card Decks:"), distributionDecks);
+    distribution->addRow(i18n("Running Count:"), distributionLabel);
+    dealerLabel = new QLabel();
+    dealerLabel->setWordWrap(true);
+    distribution->addRow(i18n("Dealer Busts:"), dealerLabel);
+    body->addLayout(distribution);
     body->addStretch();
     body->addWidget(dialogButtons);
-    fillList();
+    updateWeightMatrix();
+    updateMetrics();
 
-    listWidget->setCurrentItem(listWidget->item(0));
+    listView->setCurrentIndex(listModel->index(0, 0));
     connect(saveButton, &QPushButton::clicked, this, [=]() {
         // todo: check if the name is new
-        QVector<qint32> currentWeights;
-        for (auto &weight: weights) {
-            currentWeights.push_back(weight->value());
+        const QVector<qint32> currentWeights = rankStrip->weights();
+        const bool wasFake = _id == model->fakeRow();
+        if (descriptionTimer->isActive()) {
+            descriptionTimer->stop();
+            _description->setMarkdown(model->strategy(_id)->getName(), _descriptionInput->toMarkdown());
         }
-        items[_id] = new Strategy(_name->text(), _description->text(),
-                                  currentWeights, true);
-        KConfigGroup strategyGroup = strategiesGroup->group(items[_id]->getName());
-        strategyGroup.writeEntry("description", items[_id]->getDescription());
-        strategyGroup.writeEntry("weights", currentWeights.toList());
-        strategiesGroup->config()->sync();
-        listWidget->currentItem()->setText(_name->text());
-        addFakeStrategy();
-        emit newStrategy();
-    });
-    connect(listWidget, &QListWidget::itemSelectionChanged, this,
-            [=]() { showStrategyByName(listWidget->currentItem()->text()); });
-    connect(searchBox, &QLineEdit::textChanged, this, [=](const QString &text) {
-        for (int i = 0; i < listWidget->count(); i++) {
-            auto *item = listWidget->item(i);
-            bool matches = item->text().contains(text, Qt::CaseInsensitive);
-            item->setHidden(!matches);
+        auto *saved = new Strategy(_name->text(), _description->markdown(), currentWeights, true);
+        model->replaceStrategy(_id, saved);
+        store->save(saved);
+        if (wasFake) {
+            addFakeStrategy();
         }
+        updateWeightMatrix();
+        emit newStrategy();
     });
+    connect(listView->selectionModel(), &QItemSelectionModel::currentChanged, this,
+            [=](const QModelIndex &current) {
+                if (current.isValid()) {
+                    showStrategyByName(current.data().toString());
+                }
+            });
+    connect(searchBox, &QLineEdit::textChanged, listModel, &StrategyFilterModel::setQuery);
     connect(_nameInput, &QLineEdit::textChanged, this,
             [=](const QString &text) { _name->setText(text); });
-    connect(_descriptionInput, &QTextEdit::textChanged, this,
-            [=]() { _description->setText(_descriptionInput->toMarkdown()); });
+    // a keystroke only restarts the timer, the document is serialized and laid out once typing pauses
+    connect(_descriptionInput, &QTextEdit::textChanged, descriptionTimer, QOverload<>::of(&QTimer::start));
+    connect(descriptionTimer, &QTimer::timeout, this, [=]() {
+        _description->setMarkdown(model->strategy(_id)->getName(), _descriptionInput->toMarkdown());
+    });
+    connect(distributionDecks, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &StrategyInfo::updateDistribution);
+    connect(distributionWatcher, &QFutureWatcher<CountDistribution>::finished, this, [=]() {
+        if (distributionStale) {
+            updateDistribution();
+        } else {
+            showDistribution(distributionWatcher->result());
+        }
+    });
+    connect(optimizeButton, &QPushButton::clicked, this, &StrategyInfo::toggleOptimizer);
+    connect(optimizer, &StrategyOptimizer::candidateFound, this, &StrategyInfo::showCandidate);
+    connect(optimizerWatcher, &QFutureWatcher<void>::finished, this, [=]() {
+        optimizeButton->setText(i18n("&Optimize"));
+        optimizeMetric->setEnabled(true);
+        optimizeLevel->setEnabled(true);
+        optimizeBalanced->setEnabled(true);
+        if (optimized) {
+            store->save(optimized);
+            optimized = nullptr;
+            emit newStrategy();
+        }
+    });
+    connect(importButton, &QPushButton::clicked, this, &StrategyInfo::importStrategies);
+    connect(exportButton, &QPushButton::clicked, this, &StrategyInfo::exportStrategies);
+    connect(transfer, &StrategyTransfer::batchImported, this, [=](const QVector<Strategy *> &strategies) {
+        const QVector<Strategy *> accepted = addStrategies(strategies);
+        store->save(accepted);
+        imported += accepted.size();
+        transferLabel->setText(i18n("Importing… %1", imported));
+    });
+    connect(transfer, &StrategyTransfer::importFinished, this,
+            [=](qint64 count, qint64 duplicates, qint64 invalid) {
+                importButton->setEnabled(true);
+                // names taken by a built-in strategy or repeated in the catalog are skipped as duplicates
+                transferLabel->setText(i18n("Imported %1 strategies, skipped %2 duplicates and %3 invalid lines.",
+                                            imported, duplicates + count - imported, invalid));
+                // the figures of all strategies are computed once, not per batch
+                updateWeightMatrix();
+                emit newStrategy();
+            });
     connect(dialogButtons, &QDialogButtonBox::accepted, this, &QDialog::accept);
     connect(dialogButtons, &QDialogButtonBox::rejected, this, &QDialog::reject);
 
     saveButton->hide();
     _nameInput->hide();
     _descriptionInput->hide();
+    updateDistribution();
 }
 
 Strategy *StrategyInfo::getStrategyById(qint32 id) {
-    return items[id];
+    return model->strategy(id);
 }
 
 void StrategyInfo::showStrategyByName(const QString &name) {
-    qint32 id = -1;
-    for (int i = 0; i < items.size(); i++) {
-        if (items[i]->getName() == name) {
-            id = i;
-            break;
-        }
-    }
+    const qint32 id = model->rowOf(name);
     if (id != -1 && _id != id) {
         _id = id;
-        _name->setText(items[_id]->getName());
-        _description->setText(items[_id]->getDescription());
-        if (id + 1 < items.size()) {
+        Strategy *strategy = model->strategy(_id);
+        _name->setText(strategy->getName());
+        _description->setMarkdown(strategy->getName(), strategy->getDescription());
+        if (id != model->fakeRow()) {
             _nameInput->setText(_name->text());
-            _descriptionInput->setText(_description->text());
+            _descriptionInput->setText(_description->markdown());
         }
-        bool isCustom = items[_id]->isCustom();
+        // the description is shown as it is, not as serialized by the input, and a preview still pending
+        // for the previous strategy must not overwrite it
+        descriptionTimer->stop();
+        bool isCustom = strategy->isCustom();
         _descriptionInput->setHidden(!isCustom);
         _nameInput->setHidden(!isCustom);
         saveButton->setHidden(!isCustom);
-        for (int i = Cards::Rank::Ace; i <= Cards::Rank::King; i++) {
-            weights[i - Cards::Rank::Ace]->setValue(items[_id]->getWeights(i - Cards::Rank::Ace));
-            weights[i - Cards::Rank::Ace]->setReadOnly(!isCustom);
-        }
+        rankStrip->setWeights(weightsOf(strategy));
+        rankStrip->setReadOnly(!isCustom);
+        updateDistribution();
     }
 }
 
 QVector<Strategy *> StrategyInfo::getStrategies() {
-    return items;
+    return model->strategies();
 }
 
-void StrategyInfo::initStrategies() {
-
-
-    items.push_back(new Strategy(
-            "Hi-Opt I Count",
-            "The Hi-Opt I blackjack card counting system was developed by Charles Einstein and introduced in his book "
-            "\"The World's Greatest Blackjack Book\" in 1980. The Hi-Opt I system assigns point values to each card in "
-            "the deck and is a more complex system than the Hi-Lo system, with additional point values for some cards. "
-            "It is considered a more powerful system than the Hi-Lo, but also more difficult to learn "
-            "and use effectively.",
-            {0, 0, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1}));
-
-    items.push_back(new Strategy(
-            "Hi-Lo Count",
-            "The Hi-Lo blackjack card counting system was first introduced by Harvey Dubner in 1963. Dubner's goal was "
-            "to create a simple yet effective system that could be used by anyone to increase their odds of winning "
-            "at blackjack.",
-            {-1, 1, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1}));
-
-    items.push_back(new Strategy(
-            "Hi-Opt II Count",
-            "The Hi-Opt II blackjack card counting system is a more advanced version of the Hi-Opt I system, "
-            "developed by Lance Humble and Carl Cooper in their book \"The World's Greatest Blackjack Book\" in 1980. "
-            "The Hi-Opt II system assigns point values to each card in the deck, with additional point values "
-            "for some cards, and is considered one of the most powerful card counting systems. It is also one of "
-            "the most difficult to learn and use effectively.",
-            {0, 1, 1, 2, 2, 1, 1, 0, 0, -2, -2, -2, -2}));
-
-    items.push_back(new Strategy(
-            "KO Count",
-            "The Knock-Out (KO) blackjack card counting system was developed by Olaf Vancura and Ken Fuchs in their "
-            "book \"Knock-Out Blackjack\" in 1998. The KO system assigns point values to each card in the deck, with "
-            "the additional advantage that it does not require a true count conversion for betting, making it easier "
-            "to use than some other systems.",
-            {-1, 1, 1, 1, 1, 1, 1, 0, 0, -1, -1, -1, -1}));
-
-    items.push_back(new Strategy(
-            "Omega II Count",
-            "The Omega II blackjack card counting system was developed by Bryce Carlson and introduced in his book "
-            "\"Blackjack for Blood\" in 2001. The Omega II system assigns point values to each card in the deck, with "
-            "additional point values for some cards, and is considered one of the most powerful card counting systems, "
-            "especially for multi-deck games.",
-            {0, 1, 1, 2, 2, 2, 1, 0, -1, -2, -2, -2, -2}));
-
-    items.push_back(new Strategy(
-            "Zen Count",
-            "The Zen Count blackjack card counting system was developed by Arnold Snyder and introduced in his book "
-            "\"Blackbelt in Blackjack\" in 1983. The Zen Count system assigns point values to each card in the deck, "
-            "with additional point values for some cards, and is considered a powerful system for both single "
-            "and multi-deck games.",
-            {-1, 1, 1, 2, 2, 2, 1, 0, 0, -2, -2, -2, -2}));
-
-    items.push_back(new Strategy(
-            "10 Count",
-            "The 10 Count blackjack card counting system was developed by Edward O. Thorp, a mathematician and author "
-            "of the classic book \"Beat the Dealer\" in 1962. The 10 Count system assigns point values to each card in "
-            "the deck, with a focus on the 10-value cards, and is considered one of the earliest "
-            "and most basic card counting systems.",
-            {1, 1, 1, 1, 1, 1, 1, 1, 1, -2, -2, -2, -2}));
-
-    QStringList strategyNames = strategiesGroup->groupList();
-    for (const auto &strategyName: strategyNames) {
-        KConfigGroup strategyGroup = strategiesGroup->group(strategyName);
-        items.push_back(new Strategy(
-                strategyName, strategyGroup.readEntry("description", ""),
-                QVector<int>::fromList(strategyGroup.readEntry("weights", QList<int>())),
-                true));
+StrategyFilterModel *StrategyInfo::getSlotModel() const {
+    return slotModel;
+}
 
-    }
+void StrategyInfo::initStrategies() {
+    model = new StrategyModel(this);
+    model->setStrategies(Strategy::loadStrategies(*strategiesGroup));
+    addFakeStrategy();
+    listModel = new StrategyFilterModel(model, true, this);
+    listModel->sort(0);
+    // the combo boxes keep the order of the model
+    slotModel = new StrategyFilterModel(model, false, this);
 }
 
 void StrategyInfo::addFakeStrategy() {
-    items.push_back(new Strategy(
+    model->insertStrategies(model->rowCount(), {new Strategy(
             "New Strategy",
             "Some Notes (use Markdown)",
             {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-            true));
-    listWidget->sortItems();
-    auto *widgetItem = new QListWidgetItem(items.last()->getName());
-    listWidget->addItem(widgetItem);
+            true)});
 }
 
-void StrategyInfo::fillList() {
-    for (auto &item: items) {
-        auto *widgetItem = new QListWidgetItem(item->getName());
-        listWidget->addItem(widgetItem);
+QVector<qint32> StrategyInfo::currentWeights() const {
+    return rankStrip->weights();
+}
+
+void StrategyInfo::updateDistribution() {
+    updateDealerOutcomes();
+    if (distributionWatcher->isRunning()) {
+        distributionStale = true;
+        return;
     }
-    addFakeStrategy();
+    distributionStale = false;
+    distributionLabel->setText(i18n("Computing…"));
+    distributionWatcher->setFuture(QtConcurrent::run(&CountDistribution::load,
+                                                     currentWeights(), qint32(distributionDecks->value())));
+}
+
+void StrategyInfo::showDistribution(const CountDistribution &distribution) {
+    QStringList lines;
+    for (qint32 penetration: {25, 50, 75}) {
+        qint32 depth = distribution.cardCount() * penetration / 100;
+        lines.push_back(i18n("after %1% of the shoe: 90% within [%2, %3], σ = %4", penetration,
+                             distribution.percentile(depth, 0.05), distribution.percentile(depth, 0.95),
+                             QString::number(distribution.stddev(depth), 'f', 2)));
+    }
+    distributionLabel->setText(lines.join(QLatin1Char('\n')));
+}
+
+void StrategyInfo::updateDealerOutcomes() {
+    CC_TRACE_SPAN("StrategyInfo::updateDealerOutcomes");
+    const QVector<qint32> shown = currentWeights();
+    const qint32 deckCount = distributionDecks->value();
+    const QVector<qint32> full = DealerOutcomes::fullShoe(deckCount);
+
+    // takes the cards with positive weights out in turn until the true count per deck of 54 cards reaches +2
+    QVector<qint32> rich = full;
+    qint32 count = 0;
+    qint32 remaining = 54 * deckCount;
+    for (qint32 rank = 0; count * 54 < 2 * remaining;) {
+        qint32 tries = 0;
+        while ((shown[rank] <= 0 || !rich[rank]) && tries++ < 13) {
+            rank = (rank + 1) % 13;
+        }
+        if (tries > 13) {
+            rich.clear(); // nothing left to take out
+            break;
+        }
+        rich[rank]--;
+        count += shown[rank];
+        remaining--;
+        rank = (rank + 1) % 13;
+    }
+
+    QStringList lines;
+    for (qint32 upcard: {2, 3, 4, 5, 6, 7, 8, 9, 10, 1}) {
+        QVector<qint32> neutral = full;
+        neutral[upcard - 1]--;
+        const double bust = dealerOutcomes.compute(neutral, upcard, true).probability(DealerOutcomes::Bust);
+        QString line = i18n("%1: %2%", upcard == 1 ? i18n("A") : QString::number(upcard),
+                            QString::number(100 * bust, 'f', 1));
+        if (!rich.isEmpty() && rich[upcard - 1]) {
+            QVector<qint32> counted = rich;
+            counted[upcard - 1]--;
+            const double richBust = dealerOutcomes.compute(counted, upcard, true).probability(DealerOutcomes::Bust);
+            line = i18n("%1 → %2% at +2", line, QString::number(100 * richBust, 'f', 1));
+        }
+        lines.push_back(line);
+    }
+    const DealerOutcomes::Stats stats = dealerOutcomes.stats();
+    dealerLabel->setText(lines.join(QLatin1String(", ")));
+    dealerLabel->setToolTip(i18n("%1 cached outcomes, %2% hit rate", stats.entries,
+                                 QString::number(100 * stats.hitRate(), 'f', 1)));
 }
 
+void StrategyInfo::updateWeightMatrix() {
+    const WeightMatrix weightMatrix(model->strategies());
+    const QVector<StrategyMetrics::Metrics> metrics = StrategyMetrics::compute(weightMatrix);
+    QVector<QString> toolTips;
+    toolTips.reserve(metrics.size());
+    for (const StrategyMetrics::Metrics &figures: metrics) {
+        toolTips.push_back(i18n("Level %1, BC %2, PE %3, IC %4", figures.level,
+                                QString::number(figures.bettingCorrelation, 'f', 2),
+                                QString::number(figures.playingEfficiency, 'f', 2),
+                                QString::number(figures.insuranceCorrelation, 'f', 2)));
+    }
+    model->setToolTips(toolTips);
+}
 
+void StrategyInfo::updateMetrics() {
+    const StrategyMetrics::Metrics figures = StrategyMetrics::compute(currentWeights());
+    metricsLabel->setText(i18n("Balance per deck: %1 (%2)\nLevel: %3\n"
+                               "Betting correlation: %4\nPlaying efficiency: %5\n"
+                               "Insurance correlation: %6",
+                               figures.balance, figures.balance ? i18n("unbalanced") : i18n("balanced"),
+                               figures.level,
+                               QString::number(figures.bettingCorrelation, 'f', 3),
+                               QString::number(figures.playingEfficiency, 'f', 3),
+                               QString::number(figures.insuranceCorrelation, 'f', 3)));
+}
+
+void StrategyInfo::toggleOptimizer() {
+    if (optimizerWatcher->isRunning()) {
+        optimizer->cancel();
+        return;
+    }
+    const auto metric = StrategyMetrics::Metric(optimizeMetric->currentIndex());
+    optimizedName = StrategyOptimizer::strategyName(metric, optimizeLevel->value(), optimizeBalanced->isChecked());
+    optimized = nullptr;
+    optimizeButton->setText(i18n("S&top"));
+    optimizeMetric->setEnabled(false);
+    optimizeLevel->setEnabled(false);
+    optimizeBalanced->setEnabled(false);
+    optimizerWatcher->setFuture(optimizer->start(metric, optimizeLevel->value(), optimizeBalanced->isChecked()));
+}
+
+void StrategyInfo::showCandidate(const QVector<qint32> &weights, double score) {
+    const auto metric = StrategyMetrics::Metric(optimizeMetric->currentIndex());
+    auto *candidate = new Strategy(optimizedName, StrategyOptimizer::strategyDescription(metric, score), weights,
+                                   true);
+    optimized = addStrategy(candidate) ? candidate : nullptr;
+}
+
+bool StrategyInfo::addStrategy(Strategy *strategy) {
+    const bool isAdded = !addStrategies({strategy}).isEmpty();
+    updateWeightMatrix();
+    return isAdded;
+}
+
+QVector<Strategy *> StrategyInfo::addStrategies(const QVector<Strategy *> &strategies) {
+    // the same name twice in one batch, the last one wins
+    QHash<QString, qint32> positions;
+    QVector<Strategy *> unique;
+    for (Strategy *strategy: strategies) {
+        auto position = positions.constFind(strategy->getName());
+        if (position == positions.constEnd()) {
+            positions.insert(strategy->getName(), unique.size());
+            unique.push_back(strategy);
+        } else {
+            delete unique[position.value()];
+            unique[position.value()] = strategy;
+        }
+    }
+
+    const qint32 fake = model->fakeRow();
+    QVector<Strategy *> accepted;
+    QVector<Strategy *> added;
+    QVector<Strategy *> replaced;
+    for (Strategy *strategy: unique) {
+        const qint32 row = model->rowOf(strategy->getName());
+        if (row == -1 || row == fake) {
+            added.push_back(strategy);
+        } else if (!model->strategy(row)->isCustom()) {
+            // the built-in strategies are not stored, a replacement would be added next to them on the next start
+            delete strategy;
+            continue;
+        } else {
+            if (optimized == model->strategy(row)) {
+                optimized = strategy;
+            }
+            replaced.push_back(model->strategy(row));
+            model->replaceStrategy(row, strategy);
+            if (_id == row) {
+                _id = -1; // show the new weights
+                showStrategyByName(strategy->getName());
+            }
+        }
+        accepted.push_back(strategy);
+    }
+    if (!replaced.isEmpty()) {
+        // the table slots may still count with the replaced strategies
+        emit newStrategy();
+        qDeleteAll(replaced);
+    }
+    if (!added.isEmpty()) {
+        if (_id == fake) {
+            _id += added.size(); // the fake strategy moves down
+        }
+        model->insertStrategies(fake, added);
+    }
+    return accepted;
+}
+
+void StrategyInfo::importStrategies() {
+    const QString path = QFileDialog::getOpenFileName(this, i18n("Import Strategies"), QString(),
+                                                      i18n("Strategy catalogs (*.jsonl);;All files (*)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    importButton->setEnabled(false);
+    transferLabel->setText(i18n("Importing…"));
+    imported = 0;
+    transfer->importFrom(path, model->strategies().mid(0, model->fakeRow()));
+}
+
+void StrategyInfo::exportStrategies() {
+    const QString path = QFileDialog::getSaveFileName(this, i18n("Export Strategies"), QString(),
+                                                      i18n("Strategy catalogs (*.jsonl);;All files (*)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    // an import or the optimizer may replace strategies while the file is written, so the pool only sees copies
+    QVector<QJsonObject> custom;
+    for (qint32 row = 0; row < model->fakeRow(); row++) {
+        if (model->strategy(row)->isCustom()) {
+            custom.push_back(model->strategy(row)->toJson());
+        }
+    }
+    exportButton->setEnabled(false);
+    transferLabel->setText(i18n("Exporting…"));
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [=]() {
+        exportButton->setEnabled(true);
+        transferLabel->setText(watcher->result() ? i18np("Exported %1 strategy.", "Exported %1 strategies.",
+                                                         custom.size())
+                                                 : i18n("Cannot write %1.", path));
+        watcher->deleteLater();
+    });
+    watcher->setFuture(StrategyTransfer::exportTo(path, custom));
+}
@@ -23,6 +23,11 @@
 
 // Qt
 #include <QDialog>
+#include <QFutureWatcher>
+// own
+#include "countdistribution.hpp"
+#include "strategymetrics.hpp"
+#include "src/engine/dealeroutcomes.hpp"
 
 class Strategy;
 
@@ -30,6 +35,12 @@ class QSvgRenderer;
 
 class QLabel;
 
+class QTimer;
+
+class MarkdownPreview;
+
+class RankStrip;
+
 class QSpinBox;
 
 class QPushButton;
@@ -38,7 +49,21 @@ class QLineEdit;
 
 class QTextEdit;
 
-class QListWidget;
+class QListView;
+
+class QComboBox;
+
+class QCheckBox;
+
+class StrategyOptimizer;
+
+class StrategyStore;
+
+class StrategyModel;
+
+class StrategyFilterModel;
+
+class StrategyTransfer;
 
 class KConfigGroup;
 
@@ -79,6 +104,13 @@ public:
      */
     QVector<Strategy *> getStrategies();
 
+    /**
+     * @brief Returns the strategies for the combo boxes of the table slots, without the placeholder for a new one.
+     *
+     * @return The shared proxy model.
+     */
+    StrategyFilterModel *getSlotModel() const;
+
 signals:
 
     /**
@@ -87,20 +119,44 @@ signals:
     void newStrategy();
 
 private:
-    QVector<Strategy *> items; ///< The strategies currently being displayed.
+    StrategyModel *model; ///< All strategies, the placeholder for a new one last.
+    StrategyFilterModel *listModel; ///< The sorted and searched strategies of the list.
+    StrategyFilterModel *slotModel; ///< The strategies of the combo boxes of the table slots.
     QSvgRenderer *m_renderer; ///< The SVG renderer to use for rendering card images.
     qint32 _id; ///< The ID of the currently selected strategy.
     QLabel *_name; ///< The label displaying the name of the currently selected strategy.
-    QLabel *_description; ///< The label displaying the description of the currently selected strategy.
+    MarkdownPreview *_description; ///< The preview of the description of the currently selected strategy.
     QLineEdit *_nameInput; ///< The input field for editing the name of the currently selected strategy.
     QTextEdit *_descriptionInput; ///< The input field for editing the description of the currently selected strategy.
+    QTimer *descriptionTimer; ///< Delays the preview of the edited description until typing pauses.
     QPushButton *saveButton; ///< The button for saving changes to the currently selected strategy.
-    QListWidget *listWidget; ///< The list of available strategies.
-    QVector<QSpinBox *> weights; ///< The list of spin boxes for editing strategy weights.
+    QListView *listView; ///< The list of available strategies.
+    RankStrip *rankStrip; ///< The cards of all ranks with the weights of the shown strategy.
     KConfigGroup *strategiesGroup; ///< The configuration group containing the list of strategies.
+    StrategyStore *store; ///< Writes the saved strategies to the configuration in the background.
+    QSpinBox *distributionDecks; ///< The number of decks the running count distribution is shown for.
+    QLabel *distributionLabel; ///< The label summarizing the running count distribution.
+    QFutureWatcher<CountDistribution> *distributionWatcher; ///< The watcher of the distribution computation.
+    bool distributionStale = false; ///< Whether the weights changed while the distribution was computed.
+    QLabel *metricsLabel; ///< The label showing the figures of the shown weights.
+    QLabel *dealerLabel; ///< The label showing the dealer's bust probabilities by upcard.
+    DealerOutcomes dealerOutcomes{Rules()}; ///< The memoized dealer outcomes, shared by all shown weights.
+    StrategyOptimizer *optimizer; ///< The search for the best weights.
+    QFutureWatcher<void> *optimizerWatcher; ///< The watcher of the running search.
+    QComboBox *optimizeMetric; ///< The metric the search maximizes.
+    QSpinBox *optimizeLevel; ///< The largest absolute weight of the search.
+    QCheckBox *optimizeBalanced; ///< Whether the search only accepts balanced weights.
+    QPushButton *optimizeButton; ///< The button starting and stopping the search.
+    QString optimizedName; ///< The name of the strategy the running search streams into.
+    Strategy *optimized = nullptr; ///< The best strategy of the running search, saved when it finishes.
+    StrategyTransfer *transfer; ///< Imports and exports strategy catalogs.
+    QPushButton *importButton; ///< The button importing a catalog.
+    QPushButton *exportButton; ///< The button exporting the custom strategies.
+    QLabel *transferLabel; ///< The progress and result of the last import or export.
+    qint64 imported = 0; ///< The number of strategies the running import delivered so far.
 
     /**
-     * @brief Initializes the list of built-in strategies.
+     * @brief Loads the strategies into the model and creates the proxies of the list and the table slots.
      */
     void initStrategies();
 
@@ -110,9 +166,75 @@ private:
     void addFakeStrategy();
 
     /**
-     * @brief Fills the list of available strategies with the current set of strategies.
+     * @brief Loads the running count distribution of the shown weights in the background.
+     */
+    void updateDistribution();
+
+    /**
+     * @brief Shows the summary of a computed running count distribution.
+     * @param distribution The distribution to show.
+     */
+    void showDistribution(const CountDistribution &distribution);
+
+    /**
+     * @brief Shows the dealer's bust probability by upcard for a full shoe of the chosen number of decks and for
+     * one at a true count of +2 of the shown weights. The outcomes are exact and cheap enough to compute in place.
+     */
+    void updateDealerOutcomes();
+
+    /**
+     * @brief Returns the weights currently shown in the spin boxes.
+     * @return The 13 weights from ace to king.
+     */
+    QVector<qint32> currentWeights() const;
+
+    /**
+     * @brief Rebuilds the weight matrix and the figures of all strategies shown as list tooltips.
+     */
+    void updateWeightMatrix();
+
+    /**
+     * @brief Shows the figures of the weights in the spin boxes, called on every change.
+     */
+    void updateMetrics();
+
+    /**
+     * @brief Starts the optimizer with the chosen settings, or stops it if it is running.
+     */
+    void toggleOptimizer();
+
+    /**
+     * @brief Shows a better vector found by the running search in the list of strategies.
+     * @param weights The 13 weights from ace to king.
+     * @param score The value of the maximized metric.
+     */
+    void showCandidate(const QVector<qint32> &weights, double score);
+
+    /**
+     * @brief Adds a custom strategy in front of the fake one, or replaces the custom strategy with the same name.
+     * @param strategy The strategy to add, deleted if a built-in strategy has its name.
+     * @return True if the strategy was added, false if it was deleted.
+     */
+    bool addStrategy(Strategy *strategy);
+
+    /**
+     * @brief Adds custom strategies in front of the fake one, or replaces the custom strategies with the same
+     * names, without rebuilding the weight matrix. Replaced strategies, strategies named like a built-in one
+     * and all but the last of several with the same name are deleted.
+     * @param strategies The strategies to add.
+     * @return The strategies in the list now, in the given order.
+     */
+    QVector<Strategy *> addStrategies(const QVector<Strategy *> &strategies);
+
+    /**
+     * @brief Asks for a catalog file and imports it in the background.
+     */
+    void importStrategies();
+
+    /**
+     * @brief Asks for a file and exports the custom strategies to it in the background.
      */
-    void fillList();
+    void exportStrategies();
 };
 
 #endif //CARD_COUNTER_STRATEGYINFO_HPP
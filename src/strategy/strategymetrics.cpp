@@ -0,0 +1,189 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <numeric>
+// Qt
+#include <QtMath>
+// own
+#include "strategymetrics.hpp"
+#include "weightmatrix.hpp"
+#include "src/engine/dealeroutcomes.hpp"
+#include "src/engine/deviationindices.hpp"
+#include "src/widgets/cards.hpp"
+
+namespace {
+    /**
+     * Effect of removal of one card of every rank from ace to king on the player's expectation
+     * in percent (P. Griffin, The Theory of Blackjack), ten-valued cards repeated.
+     */
+    const double bettingReference[13] = {-0.61, 0.38, 0.44, 0.55, 0.69, 0.46, 0.28, 0.00, -0.18,
+                                         -0.51, -0.51, -0.51, -0.51};
+
+    /**
+     * Effect of removal on the insurance bet: only tens matter, removing a non-ten helps by 4/9 of a ten.
+     */
+    const double insuranceReference[13] = {4, 4, 4, 4, 4, 4, 4, 4, 4, -9, -9, -9, -9};
+
+    /**
+     * Accumulates the correlation of every strategy with a reference vector.
+     */
+    struct Correlation {
+        explicit Correlation(const double *reference) : reference(reference) {
+            for (qint32 i = 0; i < 13; i++) {
+                sum += reference[i];
+                squares += reference[i] * reference[i];
+            }
+        }
+
+        double value(double weightSum, double weightSquares, double product) const {
+            double variance = (13 * weightSquares - weightSum * weightSum) * (13 * squares - sum * sum);
+            return variance > 0 ? (13 * product - weightSum * sum) / qSqrt(variance) : 0;
+        }
+
+        const double *reference;
+        double sum = 0;
+        double squares = 0;
+    };
+
+    /**
+     * The weighted mean of the playing decisions: their effects of removal centered, scaled to unit length and
+     * turned like the betting reference, so the correlation with every play adds up as one dot product.
+     */
+    struct PlayingReference {
+        double values[13] = {}; ///< The mean of the unit effects of removal of the plays.
+        double scale = 0; ///< The length of the mean, the playing efficiency of a perfectly correlated count.
+    };
+
+    const PlayingReference &playingReference() {
+        // computed once from the exact results of the dealer, the plays are the same for every strategy
+        static const PlayingReference reference = []() {
+            PlayingReference mean;
+            const QVector<qint32> deck = DealerOutcomes::fullShoe(1);
+            const auto cards = [&](qint32 value) {
+                return value == 10 ? 4 * deck[9] : deck[value - 1];
+            };
+            double total = 0;
+            for (const DeviationIndices::Play &play: DeviationIndices::plays()) {
+                if (!play.first) {
+                    // the insurance bet has its own correlation
+                    continue;
+                }
+                const QVector<double> effects = DeviationIndices::effectOfRemoval(Rules(), play);
+                const double average = std::accumulate(effects.cbegin(), effects.cend(), 0.0) / 13;
+                double length = 0;
+                double betting = 0;
+                for (qint32 i = 0; i < 13; i++) {
+                    length += (effects[i] - average) * (effects[i] - average);
+                    betting += (effects[i] - average) * bettingReference[i];
+                }
+                if (length <= 0) {
+                    continue;
+                }
+                // a play counts as often as its hand is dealt from a full deck
+                const double frequency = (play.first == play.second ? 1 : 2) * cards(play.first)
+                                         * (cards(play.second) - (play.first == play.second))
+                                         * (cards(play.upcard) - (play.upcard == play.first)
+                                            - (play.upcard == play.second));
+                const double factor = (betting < 0 ? -frequency : frequency) / qSqrt(length);
+                for (qint32 i = 0; i < 13; i++) {
+                    mean.values[i] += factor * (effects[i] - average);
+                }
+                total += frequency;
+            }
+            double length = 0;
+            for (double &value: mean.values) {
+                value /= total;
+                length += value * value;
+            }
+            mean.scale = qSqrt(length);
+            return mean;
+        }();
+        return reference;
+    }
+}
+
+double StrategyMetrics::scale(Metric metric) {
+    return metric == Playing ? playingReference().scale : 1;
+}
+
+const double *StrategyMetrics::reference(Metric metric) {
+    switch (metric) {
+        case Playing:
+            return playingReference().values;
+        case Insurance:
+            return insuranceReference;
+        case Betting:
+        default:
+            return bettingReference;
+    }
+}
+
+template<typename Column>
+QVector<StrategyMetrics::Metrics> StrategyMetrics::compute(Column column, qint32 stride, qint32 count) {
+    QVector<qint32> balance(stride, 0);
+    QVector<qint32> level(stride, 0);
+    QVector<double> sums(stride, 0.0);
+    QVector<double> squares(stride, 0.0);
+    QVector<double> betting(stride, 0.0);
+    QVector<double> insurance(stride, 0.0);
+    QVector<double> playing(stride, 0.0);
+    const double *playingValues = playingReference().values;
+
+    // rank by rank, every accumulation runs over contiguous values of all strategies
+    for (qint32 rank = Cards::Rank::Ace; rank <= Cards::Rank::King; rank++) {
+        const qint32 *weights = column(rank);
+        const qint32 i = rank - Cards::Rank::Ace;
+        for (qint32 k = 0; k < stride; k++) {
+            const double weight = weights[k];
+            balance[k] += 4 * weights[k];
+            level[k] = qMax(level[k], qAbs(weights[k]));
+            sums[k] += weight;
+            squares[k] += weight * weight;
+            betting[k] += weight * bettingReference[i];
+            insurance[k] += weight * insuranceReference[i];
+            playing[k] += weight * playingValues[i];
+        }
+    }
+
+    const Correlation bettingCorrelation(bettingReference);
+    const Correlation insuranceCorrelation(insuranceReference);
+    const Correlation playingCorrelation(playingValues);
+    const double playingScale = playingReference().scale;
+    QVector<Metrics> metrics(count);
+    for (qint32 k = 0; k < count; k++) {
+        metrics[k].balance = balance[k];
+        metrics[k].level = level[k];
+        metrics[k].bettingCorrelation = bettingCorrelation.value(sums[k], squares[k], betting[k]);
+        metrics[k].insuranceCorrelation = insuranceCorrelation.value(sums[k], squares[k], insurance[k]);
+        metrics[k].playingEfficiency = playingScale * playingCorrelation.value(sums[k], squares[k], playing[k]);
+    }
+    return metrics;
+}
+
+QVector<StrategyMetrics::Metrics> StrategyMetrics::compute(const WeightMatrix &matrix) {
+    return compute([&matrix](qint32 rank) { return matrix.column(rank); },
+                   matrix.stride(), matrix.strategyCount());
+}
+
+StrategyMetrics::Metrics StrategyMetrics::compute(const QVector<qint32> &weights) {
+    return compute([&weights](qint32 rank) { return weights.constData() + rank - Cards::Rank::Ace; },
+                   1, 1).first();
+}
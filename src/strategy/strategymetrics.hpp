@@ -0,0 +1,101 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_STRATEGYMETRICS_HPP
+#define CARD_COUNTER_STRATEGYMETRICS_HPP
+
+// Qt
+#include <QVector>
+
+class WeightMatrix;
+
+/**
+ * @brief The StrategyMetrics class computes the closed-form figures of card-counting strategies.
+ *
+ * The correlations are Pearson correlations over the 52 non-joker cards between the weights and
+ * reference effect-of-removal vectors. The playing efficiency is the mean correlation with the effects of
+ * removal of the index plays of DeviationIndices, weighted by how often their hands are dealt. Since every
+ * play enters as a unit vector, the mean is a single correlation with their weighted sum, times its length.
+ * The sums are accumulated rank by rank over the columns of a WeightMatrix, so all strategies are evaluated
+ * together in one vectorized pass.
+ */
+class StrategyMetrics {
+public:
+    /**
+     * @brief The reference vectors the correlations are computed against.
+     */
+    enum Metric {
+        Betting = 0, /**< Betting correlation. */
+        Playing, /**< Playing efficiency. */
+        Insurance /**< Insurance correlation. */
+    };
+
+    /**
+     * @brief Returns the effect-of-removal reference of a metric.
+     * @param metric The metric.
+     * @return The 13 reference values from ace to king.
+     */
+    static const double *reference(Metric metric);
+
+    /**
+     * @brief Returns the factor turning the correlation with the reference of a metric into the metric.
+     * @param metric The metric.
+     * @return The length of the mean of the plays for the playing efficiency, 1 otherwise.
+     */
+    static double scale(Metric metric);
+
+    /**
+     * @brief The figures of one strategy.
+     */
+    struct Metrics {
+        qint32 balance = 0; ///< The running count after a whole deck of 54 cards, 0 for balanced counts.
+        qint32 level = 0; ///< The largest absolute weight.
+        double bettingCorrelation = 0; ///< The correlation with the betting effect of removal.
+        double insuranceCorrelation = 0; ///< The correlation with the effect of removal on insurance.
+        double playingEfficiency = 0; ///< The mean correlation with the effects of removal of the index plays.
+    };
+
+    /**
+     * @brief Computes the figures of all strategies of a weight matrix.
+     * @param matrix The weights of the strategies.
+     * @return The figures in the row order of the matrix.
+     */
+    static QVector<Metrics> compute(const WeightMatrix &matrix);
+
+    /**
+     * @brief Computes the figures of a single weight vector, e.g. while it is edited.
+     * @param weights The 13 weights from ace to king.
+     * @return The figures.
+     */
+    static Metrics compute(const QVector<qint32> &weights);
+
+private:
+    /**
+     * @brief Computes the figures of strategies stored as rank columns.
+     * @param column Returns the weights of all strategies for a rank from ace to king.
+     * @param stride The number of values per column.
+     * @param count The number of strategies.
+     * @return The figures of the first count strategies.
+     */
+    template<typename Column>
+    static QVector<Metrics> compute(Column column, qint32 stride, qint32 count);
+};
+
+#endif //CARD_COUNTER_STRATEGYMETRICS_HPP
@@ -0,0 +1,200 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// own
+#include "strategymodel.hpp"
+#include "strategy.hpp"
+
+StrategyModel::StrategyModel(QObject *parent) : QAbstractListModel(parent) {
+}
+
+int StrategyModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : items.size();
+}
+
+QVariant StrategyModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= items.size()) {
+        return QVariant();
+    }
+    Strategy *strategy = items[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:
+            return strategy->getName();
+        case Qt::ToolTipRole:
+            return toolTips.value(index.row());
+        case DescriptionRole:
+            return strategy->getDescription();
+        case CustomRole:
+            return strategy->isCustom();
+        case FakeRole:
+            return index.row() == fakeRow();
+        default:
+            return QVariant();
+    }
+}
+
+const QVector<Strategy *> &StrategyModel::strategies() const {
+    return items;
+}
+
+Strategy *StrategyModel::strategy(qint32 row) const {
+    return items.value(row);
+}
+
+qint32 StrategyModel::rowOf(const QString &name) const {
+    return rows.value(name, -1);
+}
+
+qint32 StrategyModel::fakeRow() const {
+    return items.size() - 1;
+}
+
+void StrategyModel::setStrategies(const QVector<Strategy *> &strategies) {
+    beginResetModel();
+    items = strategies;
+    toolTips.clear();
+    rows.clear();
+    search.clear();
+    for (Strategy *strategy: items) {
+        search.insert(strategy);
+    }
+    indexNames(0);
+    endResetModel();
+}
+
+void StrategyModel::insertStrategies(qint32 row, const QVector<Strategy *> &strategies) {
+    if (strategies.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), row, row + strategies.size() - 1);
+    QVector<Strategy *> tail = items.mid(row);
+    items.resize(row);
+    items += strategies;
+    items += tail;
+    for (Strategy *strategy: strategies) {
+        search.insert(strategy);
+    }
+    if (toolTips.size() > row) {
+        toolTips.insert(row, strategies.size(), QString());
+    }
+    indexNames(row);
+    endInsertRows();
+    // the placeholder of the previous last row is a strategy now
+    if (row == items.size() - strategies.size() && row > 0) {
+        emit dataChanged(index(row - 1), index(row - 1), {FakeRole});
+    }
+}
+
+void StrategyModel::replaceStrategy(qint32 row, Strategy *strategy) {
+    rows.remove(items[row]->getName());
+    search.remove(items[row]);
+    items[row] = strategy;
+    search.insert(strategy);
+    rows.insert(strategy->getName(), row);
+    emit dataChanged(index(row), index(row));
+}
+
+void StrategyModel::setToolTips(const QVector<QString> &toolTips) {
+    this->toolTips = toolTips;
+    if (!items.isEmpty()) {
+        emit dataChanged(index(0), index(items.size() - 1), {Qt::ToolTipRole});
+    }
+}
+
+const StrategyIndex &StrategyModel::searchIndex() const {
+    return search;
+}
+
+void StrategyModel::indexNames(qint32 first) {
+    for (qint32 row = first; row < items.size(); row++) {
+        rows.insert(items[row]->getName(), row);
+    }
+}
+
+StrategyFilterModel::StrategyFilterModel(StrategyModel *source, bool showFake, QObject *parent)
+        : QSortFilterProxyModel(parent), showFake(showFake) {
+    setSourceModel(source);
+    setFilterCaseSensitivity(Qt::CaseInsensitive);
+    setSortLocaleAware(true);
+    // connected after the proxy's own handlers, which see the old matches and are corrected here
+    connect(source, &QAbstractItemModel::rowsInserted, this, &StrategyFilterModel::refresh);
+    connect(source, &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex &, const QModelIndex &, const QVector<int> &roles) {
+                if (!roles.contains(Qt::ToolTipRole) && !roles.contains(StrategyModel::FakeRole)) {
+                    refresh();
+                }
+            });
+    connect(source, &QAbstractItemModel::modelReset, this, &StrategyFilterModel::refresh);
+}
+
+Strategy *StrategyFilterModel::strategy(qint32 row) const {
+    const QModelIndex source = mapToSource(index(row, 0));
+    return source.isValid() ? static_cast<StrategyModel *>(sourceModel())->strategy(source.row()) : nullptr;
+}
+
+void StrategyFilterModel::setQuery(const QString &query) {
+    const QString trimmed = query.trimmed();
+    if (trimmed == this->query) {
+        return;
+    }
+    this->query = trimmed;
+    scores.clear();
+    if (this->query.isEmpty()) {
+        invalidate();
+    } else {
+        refresh();
+    }
+}
+
+void StrategyFilterModel::refresh() {
+    if (query.isEmpty()) {
+        return;
+    }
+    scores.clear();
+    const auto *source = static_cast<StrategyModel *>(sourceModel());
+    for (const StrategyIndex::Match &match: source->searchIndex().search(query)) {
+        scores.insert(match.strategy, match.score);
+    }
+    invalidate();
+}
+
+bool StrategyFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    if (sourceModel()->index(sourceRow, 0, sourceParent).data(StrategyModel::FakeRole).toBool()) {
+        return showFake;
+    }
+    return query.isEmpty() || scores.contains(static_cast<StrategyModel *>(sourceModel())->strategy(sourceRow));
+}
+
+bool StrategyFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const {
+    const bool leftFake = left.data(StrategyModel::FakeRole).toBool();
+    const bool rightFake = right.data(StrategyModel::FakeRole).toBool();
+    if (leftFake != rightFake) {
+        return rightFake;
+    }
+    if (!query.isEmpty()) {
+        const auto *source = static_cast<StrategyModel *>(sourceModel());
+        const qint32 leftScore = scores.value(source->strategy(left.row()));
+        const qint32 rightScore = scores.value(source->strategy(right.row()));
+        if (leftScore != rightScore) {
+            return leftScore > rightScore;
+        }
+    }
+    return QSortFilterProxyModel::lessThan(left, right);
+}
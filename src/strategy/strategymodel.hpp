@@ -0,0 +1,181 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_STRATEGYMODEL_HPP
+#define CARD_COUNTER_STRATEGYMODEL_HPP
+
+// Qt
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QHash>
+#include <QVector>
+// own
+#include "strategyindex.hpp"
+
+class Strategy;
+
+/**
+ * @brief The StrategyModel class holds all strategies for the strategy dialog and the table slots.
+ *
+ * The last row is always the placeholder the user edits to create a new strategy. Views only ever see the
+ * strategies through a StrategyFilterModel, so adding or replacing a strategy reaches the dialog list and every
+ * combo box as one row insertion or one changed row. Every change is applied to the search index as well, so
+ * saving a strategy only indexes that one.
+ */
+class StrategyModel : public QAbstractListModel {
+Q_OBJECT
+public:
+    /**
+     * @brief The data roles besides the name (display) and the figures (tooltip).
+     */
+    enum Roles {
+        DescriptionRole = Qt::UserRole + 1, /**< The description, in Markdown. */
+        CustomRole, /**< Whether the strategy is custom. */
+        FakeRole /**< Whether the row is the placeholder for a new strategy. */
+    };
+
+    /**
+     * @brief Constructs an empty model.
+     * @param parent The parent object.
+     */
+    explicit StrategyModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Returns all strategies, the placeholder last.
+     * @return The strategies in row order.
+     */
+    const QVector<Strategy *> &strategies() const;
+
+    /**
+     * @brief Returns the strategy of a row.
+     * @param row The row.
+     * @return The strategy.
+     */
+    Strategy *strategy(qint32 row) const;
+
+    /**
+     * @brief Returns the row of a strategy.
+     * @param name The name of the strategy.
+     * @return The row, or -1 if there is no such strategy.
+     */
+    qint32 rowOf(const QString &name) const;
+
+    /**
+     * @brief Returns the row of the placeholder for a new strategy.
+     * @return The last row.
+     */
+    qint32 fakeRow() const;
+
+    /**
+     * @brief Replaces all strategies.
+     * @param strategies The strategies, the placeholder last.
+     */
+    void setStrategies(const QVector<Strategy *> &strategies);
+
+    /**
+     * @brief Inserts strategies as one block of rows.
+     * @param row The row of the first inserted strategy.
+     * @param strategies The strategies.
+     */
+    void insertStrategies(qint32 row, const QVector<Strategy *> &strategies);
+
+    /**
+     * @brief Replaces the strategy of a row.
+     * @param row The row.
+     * @param strategy The new strategy.
+     */
+    void replaceStrategy(qint32 row, Strategy *strategy);
+
+    /**
+     * @brief Sets the tooltips of all rows.
+     * @param toolTips One tooltip per row.
+     */
+    void setToolTips(const QVector<QString> &toolTips);
+
+    /**
+     * @brief Returns the search index over all rows.
+     * @return The index.
+     */
+    const StrategyIndex &searchIndex() const;
+
+private:
+    /**
+     * @brief Rebuilds the rows of the names from the given row on.
+     * @param first The first row whose name may have moved.
+     */
+    void indexNames(qint32 first);
+
+    QVector<Strategy *> items; ///< The strategies in row order.
+    QVector<QString> toolTips; ///< The tooltip of every row.
+    QHash<QString, qint32> rows; ///< The row of every name.
+    StrategyIndex search; ///< The search index over all rows.
+};
+
+/**
+ * @brief The StrategyFilterModel class sorts the strategies by name and hides those not matching a search query.
+ *
+ * The query is answered by the search index of the source model, see StrategyIndex for its syntax. While a query is
+ * set, the matches are sorted by their rank first. The placeholder for a new strategy always sorts last and can be hidden, for the combo boxes of the table slots.
+ */
+class StrategyFilterModel : public QSortFilterProxyModel {
+Q_OBJECT
+public:
+    /**
+     * @brief Constructs a proxy of a strategy model.
+     * @param source The strategy model.
+     * @param showFake Whether the placeholder for a new strategy is shown.
+     * @param parent The parent object.
+     */
+    StrategyFilterModel(StrategyModel *source, bool showFake, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the strategy of a row of the proxy.
+     * @param row The row of the proxy.
+     * @return The strategy, or nullptr if there is no such row.
+     */
+    Strategy *strategy(qint32 row) const;
+
+    /**
+     * @brief Shows only the strategies matching a query.
+     * @param query The query, blank to show all strategies.
+     */
+    void setQuery(const QString &query);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    /**
+     * @brief Asks the index for the matches of the query again, after the source model changed.
+     */
+    void refresh();
+
+    bool showFake; ///< Whether the placeholder for a new strategy is shown.
+    QString query; ///< The search query, blank if all strategies are shown.
+    QHash<Strategy *, qint32> scores; ///< The score of every match of the query.
+};
+
+#endif //CARD_COUNTER_STRATEGYMODEL_HPP
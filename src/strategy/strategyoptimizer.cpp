@@ -0,0 +1,239 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <algorithm>
+#include <numeric>
+// Qt
+#include <QtConcurrent>
+#include <QtMath>
+// KF
+#include <KLocalizedString>
+// own
+#include "strategyoptimizer.hpp"
+
+StrategyOptimizer::StrategyOptimizer(QObject *parent) : QObject(parent) {
+
+}
+
+StrategyOptimizer::~StrategyOptimizer() {
+    cancel();
+    future.waitForFinished();
+}
+
+QString StrategyOptimizer::strategyName(StrategyMetrics::Metric metric, qint32 maxLevel, bool balanced) {
+    QString metricName;
+    switch (metric) {
+        case StrategyMetrics::Playing:
+            metricName = i18n("PE");
+            break;
+        case StrategyMetrics::Insurance:
+            metricName = i18n("IC");
+            break;
+        case StrategyMetrics::Betting:
+        default:
+            metricName = i18n("BC");
+    }
+    return balanced ? i18n("Optimized %1 Level %2", metricName, maxLevel)
+                    : i18n("Optimized %1 Level %2 (unbalanced)", metricName, maxLevel);
+}
+
+QString StrategyOptimizer::strategyDescription(StrategyMetrics::Metric metric, double score) {
+    QString metricName;
+    switch (metric) {
+        case StrategyMetrics::Playing:
+            metricName = i18n("playing efficiency");
+            break;
+        case StrategyMetrics::Insurance:
+            metricName = i18n("insurance correlation");
+            break;
+        case StrategyMetrics::Betting:
+        default:
+            metricName = i18n("betting correlation");
+    }
+    return i18n("Found by the strategy optimizer with a %1 of **%2**.", metricName, QString::number(score, 'f', 4));
+}
+
+QFuture<void> StrategyOptimizer::start(StrategyMetrics::Metric metric, qint32 maxLevel, bool isBalanced) {
+    balanced = isBalanced;
+    maxLevel = qBound(1, maxLevel, 5);
+    domain = {0};
+    for (qint32 level = 1; level <= maxLevel; level++) {
+        domain << level << -level;
+    }
+
+    const double *reference = StrategyMetrics::reference(metric);
+    scale = StrategyMetrics::scale(metric);
+    double mean = std::accumulate(reference, reference + 13, 0.0) / 13;
+    // the variables with the largest influence first, so the bound tightens early
+    double reach[variableCount];
+    for (qint32 i = 0; i < variableCount; i++) {
+        reach[i] = (i == 9 ? 4 : 1) * qAbs(reference[i] - mean);
+    }
+    std::iota(order, order + variableCount, 0);
+    std::stable_sort(order, order + variableCount, [&](qint32 a, qint32 b) { return reach[a] > reach[b]; });
+
+    remainingEnergy[variableCount] = 0;
+    remainingRange[variableCount] = 0;
+    for (qint32 depth = variableCount - 1; depth >= 0; depth--) {
+        multiplicity[depth] = order[depth] == 9 ? 4 : 1;
+        centered[depth] = reference[order[depth]] - mean;
+        remainingEnergy[depth] = remainingEnergy[depth + 1] + multiplicity[depth] * centered[depth] * centered[depth];
+        remainingRange[depth] = remainingRange[depth + 1] + multiplicity[depth] * maxLevel;
+    }
+    energy = remainingEnergy[0];
+    assignedCentered[0] = 0;
+    assignedMultiplicity[0] = 0;
+    for (qint32 depth = 0; depth < variableCount; depth++) {
+        assignedCentered[depth + 1] = assignedCentered[depth] + multiplicity[depth] * centered[depth];
+        assignedMultiplicity[depth + 1] = assignedMultiplicity[depth] + multiplicity[depth];
+    }
+
+    bestScore.store(0);
+    canceled.store(false);
+    visited.store(0);
+    {
+        QMutexLocker locker(&mutex);
+        best = Result();
+    }
+    tasks.clear();
+    for (qint32 first: qAsConst(domain)) {
+        for (qint32 second: qAsConst(domain)) {
+            tasks.push_back({first, second});
+        }
+    }
+    future = QtConcurrent::map(tasks, [this](Task &task) {
+        qint32 values[variableCount] = {task.first, task.second};
+        double product = 0;
+        double squares = 0;
+        qint32 sum = 0;
+        for (qint32 depth = 0; depth < 2; depth++) {
+            product += multiplicity[depth] * centered[depth] * values[depth];
+            squares += multiplicity[depth] * values[depth] * values[depth];
+            sum += multiplicity[depth] * values[depth];
+        }
+        qint64 nodes = 0;
+        search(2, values, product, squares, sum, nodes);
+        visited += nodes;
+    });
+    return future;
+}
+
+void StrategyOptimizer::cancel() {
+    canceled.store(true);
+}
+
+StrategyOptimizer::Result StrategyOptimizer::result() const {
+    QMutexLocker locker(&mutex);
+    Result result = best;
+    result.nodes = visited.load();
+    return result;
+}
+
+void StrategyOptimizer::search(qint32 depth, qint32 *values, double product, double squares, qint32 sum,
+                               qint64 &nodes) {
+    nodes++;
+    if (canceled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (balanced && qAbs(sum) > remainingRange[depth]) {
+        return;
+    }
+    if (bound(depth, product, squares, sum) <= bestScore.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (depth == variableCount - 1) {
+        scoreLast(values, product, squares, sum);
+        return;
+    }
+    const double step = multiplicity[depth] * centered[depth];
+    for (qint32 value: qAsConst(domain)) {
+        values[depth] = value;
+        search(depth + 1, values, product + step * value, squares + multiplicity[depth] * value * value,
+               sum + multiplicity[depth] * value, nodes);
+    }
+}
+
+void StrategyOptimizer::scoreLast(qint32 *values, double product, double squares, qint32 sum) {
+    const qint32 last = variableCount - 1;
+    const qint32 count = domain.size();
+    const qint32 *value = domain.constData();
+    const double weight = multiplicity[last];
+    const double step = weight * centered[last];
+    double scores[11];
+    // branch-free, so the compiler scores all values in a few vector instructions
+    for (qint32 k = 0; k < count; k++) {
+        double v = value[k];
+        double s = sum + weight * v;
+        double variance = (squares + weight * v * v - s * s / 13) * energy;
+        bool accepted = variance > 1e-9 && (!balanced || s == 0);
+        scores[k] = accepted ? (product + step * v) / qSqrt(qMax(variance, 1e-9)) : -1;
+    }
+    qint32 top = qint32(std::max_element(scores, scores + count) - scores);
+    if (scores[top] > bestScore.load(std::memory_order_relaxed)) {
+        values[last] = value[top];
+        offer(values, scores[top]);
+    }
+}
+
+double StrategyOptimizer::bound(qint32 depth, double product, double squares, qint32 sum) const {
+    // with a zero sum the score is the cosine of the weights and the centered reference;
+    // the unassigned variables can add at most sqrt(q * remainingEnergy) for q added squares
+    double reach = remainingEnergy[depth];
+    if (balanced) {
+        if (product > 0 && squares > 0) {
+            reach += product * product / squares;
+        }
+        return qSqrt(reach / energy);
+    }
+    // otherwise the score is the cosine of the weights minus their mean, and the mean is not known before
+    // the last variable; the best shift of the assigned values lets them reach the projection of their
+    // part of the reference onto the plane of the constant vector and their own centered values
+    const double count = assignedMultiplicity[depth];
+    if (count > 0) {
+        const double reference = assignedCentered[depth];
+        const double spread = squares - sum * double(sum) / count;
+        const double aligned = product - sum * reference / count;
+        reach += reference * reference / count;
+        if (spread > 1e-9) {
+            reach += aligned * aligned / spread;
+        }
+    }
+    return qSqrt(qMin(reach / energy, 1.0));
+}
+
+void StrategyOptimizer::offer(const qint32 *values, double score) {
+    QMutexLocker locker(&mutex);
+    if (score * scale <= best.score) {
+        return;
+    }
+    QVector<qint32> weights(13);
+    for (qint32 depth = 0; depth < variableCount; depth++) {
+        if (order[depth] < 9) {
+            weights[order[depth]] = values[depth];
+        } else {
+            std::fill(weights.begin() + 9, weights.end(), values[depth]);
+        }
+    }
+    best.weights = weights;
+    best.score = score * scale;
+    bestScore.store(score);
+    emit candidateFound(weights, best.score);
+}
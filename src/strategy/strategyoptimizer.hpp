@@ -0,0 +1,182 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_STRATEGYOPTIMIZER_HPP
+#define CARD_COUNTER_STRATEGYOPTIMIZER_HPP
+
+// std
+#include <atomic>
+// Qt
+#include <QObject>
+#include <QVector>
+#include <QFuture>
+#include <QMutex>
+// own
+#include "strategymetrics.hpp"
+
+/**
+ * @brief The StrategyOptimizer class searches the integer weight space for the strategy maximizing a metric.
+ *
+ * The ten-valued ranks share one weight, so the search runs over ten variables with values in
+ * [-maxLevel, maxLevel]. The tree is split on the first two variables into tasks that run on all cores
+ * and share the best score found so far. For balanced counts the correlation is a cosine in the weight
+ * space, which gives an upper bound for every partial assignment (Cauchy-Schwarz on the unassigned
+ * variables); subtrees that cannot beat the best score or reach a zero balance are cut. Unbalanced
+ * correlations do not change when all weights are shifted, so their bound allows the assigned values
+ * any shift. The last variable is scored in one vectorized loop.
+ */
+class StrategyOptimizer : public QObject {
+Q_OBJECT
+public:
+    /**
+     * @brief The best weights found by a search.
+     */
+    struct Result {
+        QVector<qint32> weights; ///< The 13 weights from ace to king, empty if nothing was found.
+        double score = 0; ///< The value of the metric.
+        qint64 nodes = 0; ///< The number of visited nodes of the search tree.
+    };
+
+    /**
+     * @brief Constructs an idle optimizer.
+     * @param parent The parent object.
+     */
+    explicit StrategyOptimizer(QObject *parent = nullptr);
+
+    /**
+     * @brief Stops the running search and waits for its threads.
+     */
+    ~StrategyOptimizer() override;
+
+    /**
+     * @brief Returns the name the winner of a search is saved under.
+     * @param metric The maximized metric.
+     * @param maxLevel The largest absolute weight.
+     * @param balanced Whether the weights were balanced.
+     * @return The strategy name.
+     */
+    static QString strategyName(StrategyMetrics::Metric metric, qint32 maxLevel, bool balanced);
+
+    /**
+     * @brief Returns the description of a found strategy.
+     * @param metric The maximized metric.
+     * @param score The value of the metric.
+     * @return The description, in Markdown.
+     */
+    static QString strategyDescription(StrategyMetrics::Metric metric, double score);
+
+    /**
+     * @brief Starts a search on the global thread pool, a running search must have finished.
+     * @param metric The metric to maximize.
+     * @param maxLevel The largest absolute weight, 1 to 5.
+     * @param balanced Whether the weights of a deck must sum up to zero.
+     * @return The future of the search, the best weights are available from result() once it finished.
+     */
+    QFuture<void> start(StrategyMetrics::Metric metric, qint32 maxLevel, bool balanced);
+
+    /**
+     * @brief Stops the running search, result() holds the best weights found so far.
+     */
+    void cancel();
+
+    /**
+     * @brief Returns the best weights of the last search.
+     * @return The result.
+     */
+    Result result() const;
+
+signals:
+
+    /**
+     * @brief This signal is emitted from the worker threads whenever a better vector is found.
+     * @param weights The 13 weights from ace to king.
+     * @param score The value of the metric.
+     */
+    void candidateFound(const QVector<qint32> &weights, double score);
+
+private:
+    static constexpr qint32 variableCount = 10; ///< Ace to nine, and the ten-valued ranks.
+
+    /**
+     * @brief A subtree with the first two variables fixed.
+     */
+    struct Task {
+        qint32 first;
+        qint32 second;
+    };
+
+    /**
+     * @brief Runs the depth-first search below the given partial assignment.
+     * @param depth The number of assigned variables.
+     * @param values The assigned values in search order.
+     * @param product The weighted sum of the values times the centered reference.
+     * @param squares The weighted sum of the squared values.
+     * @param sum The weighted sum of the values.
+     * @param nodes The counter of visited nodes.
+     */
+    void search(qint32 depth, qint32 *values, double product, double squares, qint32 sum, qint64 &nodes);
+
+    /**
+     * @brief Scores all values of the last variable at once.
+     * @param values The assigned values in search order.
+     * @param product The weighted sum of the values times the centered reference.
+     * @param squares The weighted sum of the squared values.
+     * @param sum The weighted sum of the values.
+     */
+    void scoreLast(qint32 *values, double product, double squares, qint32 sum);
+
+    /**
+     * @brief Returns the upper bound of the score of all completions of a partial assignment.
+     * @param depth The number of assigned variables.
+     * @param product The weighted sum of the values times the centered reference.
+     * @param squares The weighted sum of the squared values.
+     * @param sum The weighted sum of the values.
+     * @return The bound, at most 1.
+     */
+    double bound(qint32 depth, double product, double squares, qint32 sum) const;
+
+    /**
+     * @brief Records a complete assignment if it beats the best score.
+     * @param values The values in search order.
+     * @param score The value of the metric.
+     */
+    void offer(const qint32 *values, double score);
+
+    QVector<Task> tasks; ///< The subtrees of the running search.
+    QFuture<void> future; ///< The running or last search.
+    QVector<qint32> domain; ///< The values of every variable, smallest magnitude first.
+    qint32 order[variableCount]; ///< The variables in search order, 0 to 8 for ace to nine and 9 for the tens.
+    qint32 multiplicity[variableCount]; ///< The number of ranks sharing each variable, in search order.
+    double centered[variableCount]; ///< The reference minus its mean, in search order.
+    double remainingEnergy[variableCount + 1]; ///< The weighted squares of the centered reference from a depth on.
+    qint32 remainingRange[variableCount + 1]; ///< The largest weighted sum the variables from a depth on can add.
+    double assignedCentered[variableCount + 1]; ///< The weighted sum of the centered reference before a depth.
+    qint32 assignedMultiplicity[variableCount + 1]; ///< The number of ranks of the variables before a depth.
+    double energy = 0; ///< The weighted squares of the whole centered reference.
+    double scale = 1; ///< The factor turning the correlation searched for into the metric.
+    bool balanced = true; ///< Whether the running search only accepts balanced vectors.
+    std::atomic<double> bestScore{0}; ///< The best correlation, before the scale, read without locking to cut subtrees.
+    std::atomic<bool> canceled{false}; ///< Whether the running search was stopped.
+    std::atomic<qint64> visited{0}; ///< The visited nodes of the finished tasks.
+    mutable QMutex mutex; ///< Guards best.
+    Result best; ///< The best weights of the running or last search.
+};
+
+#endif //CARD_COUNTER_STRATEGYOPTIMIZER_HPP
@@ -0,0 +1,158 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#ifdef Q_OS_UNIX
+// POSIX
+#include <unistd.h>
+#endif
+// KF
+#include <KConfig>
+#include <KConfigGroup>
+// own
+#include "strategystore.hpp"
+#include "strategy.hpp"
+#include "strategycatalog.hpp"
+#include "src/perf/tracer.hpp"
+
+StrategyStore::StrategyStore(KConfigGroup *strategiesGroup, QObject *parent)
+        : QObject(parent), strategiesGroup(strategiesGroup) {
+    io.setMaxThreadCount(1);
+    io.setExpiryTimeout(-1);
+    debounce.setSingleShot(true);
+    debounce.setInterval(debounceMsecs);
+    connect(&debounce, &QTimer::timeout, this, &StrategyStore::flush);
+    // the owner is not necessarily destroyed before the application exits
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+        flush();
+        waitForFlushed();
+    });
+    replay();
+}
+
+StrategyStore::~StrategyStore() {
+    flush();
+    waitForFlushed();
+}
+
+void StrategyStore::save(Strategy *strategy) {
+    save(QVector<Strategy *>{strategy});
+}
+
+void StrategyStore::save(const QVector<Strategy *> &strategies) {
+    QByteArray lines;
+    for (Strategy *strategy: strategies) {
+        Edit edit;
+        edit.name = strategy->getName();
+        edit.description = strategy->getDescription();
+        for (qint32 rank = 0; rank < 13; rank++) {
+            edit.weights.push_back(strategy->getWeights(rank));
+        }
+        pending.insert(edit.name, edit);
+        lines += QJsonDocument(strategy->toJson()).toJson(QJsonDocument::Compact) + '\n';
+    }
+    // queued before any later flush on the same thread, so a flush that removes the journal has written its edits
+    QtConcurrent::run(&io, [lines]() {
+        CC_TRACE_SPAN("StrategyStore::journal");
+        const QString path = journalPath();
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile journal(path);
+        if (!journal.open(QIODevice::WriteOnly | QIODevice::Append) || journal.write(lines) != lines.size()
+            || !journal.flush()) {
+            qWarning("Cannot write the strategy journal %s", qPrintable(path));
+            return;
+        }
+#ifdef Q_OS_UNIX
+        // the journal is only worth its write if it survives a crash of the system as well
+        fsync(journal.handle());
+#endif
+    });
+    debounce.start();
+}
+
+void StrategyStore::flush() {
+    debounce.stop();
+    if (pending.isEmpty()) {
+        return;
+    }
+    const QVector<Edit> edits = pending.values().toVector();
+    pending.clear();
+    const QString configName = strategiesGroup->config()->name();
+    lastFlush = QtConcurrent::run(&io, [this, configName, edits]() {
+        const bool success = write(configName, edits);
+        if (success) {
+            // edits saved after this flush started are appended to the journal after it is removed
+            QFile::remove(journalPath());
+        }
+        QMetaObject::invokeMethod(this, [this, success]() {
+            // the shared config read the file before, so in-process readers see the new strategies
+            strategiesGroup->config()->reparseConfiguration();
+            emit flushed(success);
+        }, Qt::QueuedConnection);
+        return success;
+    });
+}
+
+void StrategyStore::waitForFlushed() {
+    io.waitForDone();
+}
+
+QString StrategyStore::journalPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+           + QStringLiteral("/strategies.journal");
+}
+
+void StrategyStore::replay() {
+    QFile journal(journalPath());
+    if (!journal.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    CC_TRACE_SPAN("StrategyStore::replay");
+    while (!journal.atEnd()) {
+        // a line cut off by the crash does not parse and is skipped
+        QScopedPointer<Strategy> strategy(Strategy::fromJson(QJsonDocument::fromJson(journal.readLine()).object()));
+        if (strategy) {
+            strategy->save(*strategiesGroup);
+        }
+    }
+    journal.close();
+    StrategyCatalog::bumpGeneration(*strategiesGroup);
+    if (strategiesGroup->sync()) {
+        journal.remove();
+    }
+}
+
+bool StrategyStore::write(const QString &configName, const QVector<Edit> &edits) {
+    CC_TRACE_SPAN("StrategyStore::write");
+    KConfig config(configName);
+    KConfigGroup group(&config, "CCStrategies");
+    for (const Edit &edit: edits) {
+        Strategy(edit.name, edit.description, edit.weights, true).save(group);
+    }
+    StrategyCatalog::bumpGeneration(group);
+    return config.sync();
+}
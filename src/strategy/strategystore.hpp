@@ -0,0 +1,130 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_STRATEGYSTORE_HPP
+#define CARD_COUNTER_STRATEGYSTORE_HPP
+
+// Qt
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QFuture>
+#include <QThreadPool>
+#include <QTimer>
+
+class Strategy;
+
+class KConfigGroup;
+
+/**
+ * @brief The StrategyStore class persists the edits of custom strategies without blocking the GUI thread.
+ *
+ * Every saved strategy is kept in memory and appended as one JSON line to a journal next to the config file,
+ * then the edits are coalesced by name and written to the CCStrategies group once no edit came in for a
+ * short while. KConfig writes the rc file to a temporary file and renames it, so the file is always either
+ * the old or the new version; the journal is removed once all edits in it are in. The journal and the rc file
+ * are written in order on a private thread, and the pending edits are written before the application quits. Edits journaled
+ * but not yet written, because the application crashed, are replayed into the config group when the next
+ * store is constructed.
+ */
+class StrategyStore : public QObject {
+Q_OBJECT
+public:
+    /**
+     * @brief Constructs the store and replays the journal left over by a crash.
+     * @param strategiesGroup The CCStrategies group of the shared config.
+     * @param parent The parent object.
+     */
+    explicit StrategyStore(KConfigGroup *strategiesGroup, QObject *parent = nullptr);
+
+    /**
+     * @brief Writes the pending edits and waits for them.
+     */
+    ~StrategyStore() override;
+
+    /**
+     * @brief Records a custom strategy, to be written with the next flush.
+     * @param strategy The strategy to save.
+     */
+    void save(Strategy *strategy);
+
+    /**
+     * @brief Records several custom strategies at once, with one journal write.
+     * @param strategies The strategies to save.
+     */
+    void save(const QVector<Strategy *> &strategies);
+
+    /**
+     * @brief Starts writing the pending edits without waiting for the debounce delay.
+     */
+    void flush();
+
+    /**
+     * @brief Waits until all started file work is done.
+     */
+    void waitForFlushed();
+
+    /**
+     * @brief Returns the journal file.
+     * @return The absolute path of the journal.
+     */
+    static QString journalPath();
+
+signals:
+
+    /**
+     * @brief This signal is emitted when a flush finished.
+     * @param success Whether the config file was written.
+     */
+    void flushed(bool success);
+
+private:
+    /**
+     * @brief The saved state of one strategy.
+     */
+    struct Edit {
+        QString name; ///< The name of the strategy, the name of its config group.
+        QString description; ///< The description.
+        QVector<qint32> weights; ///< The 13 weights from ace to king.
+    };
+
+    /**
+     * @brief Writes the journaled edits of a previous run into the config group and removes the journal.
+     */
+    void replay();
+
+    /**
+     * @brief Writes edits to the config file, run on the private thread.
+     * @param configName The name of the config file.
+     * @param edits The edits.
+     * @return True if the file was written, false otherwise.
+     */
+    static bool write(const QString &configName, const QVector<Edit> &edits);
+
+    static constexpr qint32 debounceMsecs = 500; ///< The quiet time before pending edits are written.
+
+    KConfigGroup *strategiesGroup; ///< The CCStrategies group of the shared config.
+    QThreadPool io; ///< The single thread doing all file work, in order.
+    QTimer debounce; ///< Restarted by every edit, flushes when it fires.
+    QHash<QString, Edit> pending; ///< The edits not written yet, the last one per name.
+    QFuture<bool> lastFlush; ///< The most recent flush.
+};
+
+#endif //CARD_COUNTER_STRATEGYSTORE_HPP
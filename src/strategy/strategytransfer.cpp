@@ -0,0 +1,143 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QCryptographicHash>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <QtEndian>
+// own
+#include "strategytransfer.hpp"
+#include "strategy.hpp"
+#include "src/perf/tracer.hpp"
+
+StrategyTransfer::StrategyTransfer(QObject *parent) : QObject(parent) {
+}
+
+StrategyTransfer::~StrategyTransfer() {
+    cancel();
+    running.waitForFinished();
+}
+
+QFuture<bool> StrategyTransfer::exportTo(const QString &path, const QVector<QJsonObject> &strategies) {
+    return QtConcurrent::run([path, strategies]() {
+        CC_TRACE_SPAN("StrategyTransfer::export");
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        for (const QJsonObject &strategy: strategies) {
+            file.write(QJsonDocument(strategy).toJson(QJsonDocument::Compact) + '\n');
+        }
+        return file.commit();
+    });
+}
+
+QFuture<void> StrategyTransfer::importFrom(const QString &path, const QVector<Strategy *> &known) {
+    QSet<quint64> seen;
+    seen.reserve(known.size());
+    for (Strategy *strategy: known) {
+        seen.insert(hash(strategy));
+    }
+    cancelled = false;
+    running = QtConcurrent::run(this, &StrategyTransfer::read, path, seen);
+    return running;
+}
+
+void StrategyTransfer::cancel() {
+    cancelled = true;
+}
+
+quint64 StrategyTransfer::hash(Strategy *strategy) {
+    QCryptographicHash sha1(QCryptographicHash::Sha1);
+    sha1.addData(strategy->getName().toUtf8());
+    for (qint32 rank = 0; rank < 13; rank++) {
+        sha1.addData(',' + QByteArray::number(strategy->getWeights(rank)));
+    }
+    return qFromBigEndian<quint64>(sha1.result().constData());
+}
+
+void StrategyTransfer::read(const QString &path, QSet<quint64> seen) {
+    CC_TRACE_SPAN("StrategyTransfer::import");
+    qint64 imported = 0;
+    qint64 duplicates = 0;
+    qint64 invalid = 0;
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        QVector<Strategy *> batch;
+        while (!file.atEnd() && !cancelled) {
+            const QByteArray line = file.readLine().trimmed();
+            if (line.isEmpty()) {
+                continue;
+            }
+            Strategy *strategy = Strategy::fromJson(QJsonDocument::fromJson(line).object());
+            if (!strategy) {
+                invalid++;
+                continue;
+            }
+            const quint64 key = hash(strategy);
+            if (seen.contains(key)) {
+                delete strategy;
+                duplicates++;
+                continue;
+            }
+            seen.insert(key);
+            batch.push_back(strategy);
+            imported++;
+            if (batch.size() == batchSize && !deliver(batch)) {
+                break;
+            }
+        }
+        if (!batch.isEmpty()) {
+            deliver(batch);
+        }
+    }
+    if (cancelled) {
+        return;
+    }
+    QMetaObject::invokeMethod(this, [this, imported, duplicates, invalid]() {
+        emit importFinished(imported, duplicates, invalid);
+    }, Qt::QueuedConnection);
+}
+
+bool StrategyTransfer::deliver(QVector<Strategy *> &batch) {
+    // waits for the GUI thread to catch up, but never blocks a destructor waiting for this thread
+    while (!credits.tryAcquire(1, 50)) {
+        if (cancelled) {
+            qDeleteAll(batch);
+            batch.clear();
+            return false;
+        }
+    }
+    QMetaObject::invokeMethod(this, [this, batch]() {
+        if (cancelled) {
+            qDeleteAll(batch);
+        } else {
+            // the receivers live on this thread, so the batch is handled when the signal returns
+            emit batchImported(batch);
+        }
+        credits.release();
+    }, Qt::QueuedConnection);
+    batch.clear();
+    return true;
+}
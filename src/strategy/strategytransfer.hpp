@@ -0,0 +1,127 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_STRATEGYTRANSFER_HPP
+#define CARD_COUNTER_STRATEGYTRANSFER_HPP
+
+// std
+#include <atomic>
+// Qt
+#include <QObject>
+#include <QSet>
+#include <QVector>
+#include <QJsonObject>
+#include <QFuture>
+#include <QSemaphore>
+
+class Strategy;
+
+/**
+ * @brief The StrategyTransfer class moves strategy catalogs between machines as JSON Lines files.
+ *
+ * Every line holds one strategy as written by Strategy::toJson. Both directions stream through the file on the
+ * global thread pool: an import reads a line at a time and hands the new strategies to the GUI thread in
+ * batches, and at most a few batches are in flight before the reader waits, so the memory does not grow with
+ * the size of the file apart from the 64 bit hash of every name and weight vector seen, which drops the
+ * duplicates of the catalog and of the strategies already known.
+ */
+class StrategyTransfer : public QObject {
+Q_OBJECT
+public:
+    /**
+     * @brief Constructs an idle transfer.
+     * @param parent The parent object.
+     */
+    explicit StrategyTransfer(QObject *parent = nullptr);
+
+    /**
+     * @brief Stops a running import and waits for it.
+     */
+    ~StrategyTransfer() override;
+
+    /**
+     * @brief Writes strategies to a JSON Lines file in the background, replacing it when done.
+     * @param path The file to write.
+     * @param strategies The strategies as returned by Strategy::toJson, taken on the GUI thread so the strategies
+     * may be edited, replaced or deleted while the file is written.
+     * @return The future of the export, true if the file was written.
+     */
+    static QFuture<bool> exportTo(const QString &path, const QVector<QJsonObject> &strategies);
+
+    /**
+     * @brief Starts reading a JSON Lines file, a running import must have finished.
+     * @param path The file to read.
+     * @param known The strategies that are already there.
+     * @return The future of the import.
+     */
+    QFuture<void> importFrom(const QString &path, const QVector<Strategy *> &known);
+
+    /**
+     * @brief Stops the running import after the current line, no more batches are delivered.
+     */
+    void cancel();
+
+    /**
+     * @brief Returns the hash an import deduplicates by.
+     * @param strategy The strategy.
+     * @return The first 64 bits of the SHA-1 of the name and the weights.
+     */
+    static quint64 hash(Strategy *strategy);
+
+signals:
+
+    /**
+     * @brief This signal is emitted on the GUI thread for every batch of new strategies.
+     * @param strategies The strategies, owned by the receiver.
+     */
+    void batchImported(const QVector<Strategy *> &strategies);
+
+    /**
+     * @brief This signal is emitted on the GUI thread when an import ended.
+     * @param imported The number of strategies delivered.
+     * @param duplicates The number of lines skipped as duplicates.
+     * @param invalid The number of lines that are no strategies.
+     */
+    void importFinished(qint64 imported, qint64 duplicates, qint64 invalid);
+
+private:
+    /**
+     * @brief Reads the file, run on the thread pool.
+     * @param path The file to read.
+     * @param seen The hashes of the known strategies.
+     */
+    void read(const QString &path, QSet<quint64> seen);
+
+    /**
+     * @brief Hands a batch to the GUI thread, waiting while too many batches are in flight.
+     * @param batch The strategies.
+     * @return False if the import was cancelled, true otherwise.
+     */
+    bool deliver(QVector<Strategy *> &batch);
+
+    static constexpr qint32 batchSize = 512; ///< The number of strategies per batch.
+    static constexpr qint32 batchesInFlight = 4; ///< The number of batches delivered but not handled yet.
+
+    std::atomic<bool> cancelled{false}; ///< Whether the running import should stop.
+    QSemaphore credits{batchesInFlight}; ///< One per batch that may still be delivered.
+    QFuture<void> running; ///< The running import.
+};
+
+#endif //CARD_COUNTER_STRATEGYTRANSFER_HPP
@@ -0,0 +1,118 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// std
+#include <numeric>
+// Qt
+#include <QThread>
+#include <QtConcurrent>
+// own
+#include "weightmatrix.hpp"
+#include "strategy.hpp"
+#include "src/widgets/cards.hpp"
+
+WeightMatrix::WeightMatrix(const QVector<Strategy *> &strategies)
+        : _strategyCount(strategies.size()),
+          _stride((strategies.size() + vectorWidth - 1) / vectorWidth * vectorWidth) {
+    columns.fill(0, rankCount * _stride);
+    for (qint32 k = 0; k < _strategyCount; k++) {
+        this->strategies.push_back(strategies[k]);
+        for (qint32 rank = Cards::Rank::Ace; rank <= Cards::Rank::King; rank++) {
+            columns[rank * _stride + k] = strategies[k]->getWeights(rank - Cards::Rank::Ace);
+        }
+    }
+}
+
+qint32 WeightMatrix::strategyCount() const {
+    return _strategyCount;
+}
+
+qint32 WeightMatrix::stride() const {
+    return _stride;
+}
+
+qint32 WeightMatrix::indexOf(const Strategy *strategy) const {
+    return strategies.indexOf(strategy);
+}
+
+const qint32 *WeightMatrix::column(qint32 rank) const {
+    return columns.constData() + rank * _stride;
+}
+
+QVector<qint32> WeightMatrix::trajectories(const QVector<qint32> &cards) const {
+    const qint32 size = cards.size();
+    const qint32 stride = _stride;
+    QVector<qint32> counts((size + 1) * stride, 0);
+    if (!stride) {
+        return counts;
+    }
+    qint32 *out = counts.data();
+    const qint32 *ids = cards.constData();
+    // the first row is all zero
+    const qint32 *zero = counts.constData();
+
+    // fills the rows after the cards [begin, end), starting from the given row
+    auto scan = [=](qint32 begin, qint32 end, const qint32 *start) {
+        for (qint32 i = begin; i < end; i++) {
+            const qint32 *weights = column(Cards::getRank(ids[i]));
+            const qint32 *previous = i == begin ? start : out + i * stride;
+            qint32 *current = out + (i + 1) * stride;
+            for (qint32 k = 0; k < stride; k++) {
+                current[k] = previous[k] + weights[k];
+            }
+        }
+    };
+
+    const qint32 blockCount = qMin(QThread::idealThreadCount(), size * stride / (1 << 16));
+    if (blockCount < 2) {
+        scan(0, size, zero);
+        return counts;
+    }
+
+    // every block is scanned from a zero row, then shifted by the totals of the blocks before it
+    const qint32 blockSize = (size + blockCount - 1) / blockCount;
+    QVector<qint32> blocks(blockCount);
+    std::iota(blocks.begin(), blocks.end(), 0);
+    QVector<qint32> carries(blockCount * stride, 0);
+    QtConcurrent::blockingMap(blocks, [=](qint32 block) {
+        qint32 begin = block * blockSize;
+        qint32 end = qMin(size, begin + blockSize);
+        scan(begin, end, zero);
+    });
+    for (qint32 block = 1; block < blockCount; block++) {
+        qint32 last = qMin(size, block * blockSize);
+        for (qint32 k = 0; k < stride; k++) {
+            carries[block * stride + k] = carries[(block - 1) * stride + k] + out[last * stride + k];
+        }
+    }
+    const qint32 *carry = carries.constData();
+    QtConcurrent::blockingMap(blocks, [=](qint32 block) {
+        qint32 begin = block * blockSize;
+        qint32 end = qMin(size, begin + blockSize);
+        const qint32 *offset = carry + block * stride;
+        for (qint32 i = begin + 1; i <= end; i++) {
+            qint32 *row = out + i * stride;
+            for (qint32 k = 0; k < stride; k++) {
+                row[k] += offset[k];
+            }
+        }
+    });
+    return counts;
+}
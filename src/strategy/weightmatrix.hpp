@@ -0,0 +1,94 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_WEIGHTMATRIX_HPP
+#define CARD_COUNTER_WEIGHTMATRIX_HPP
+
+// Qt
+#include <QVector>
+
+class Strategy;
+
+/**
+ * @brief The WeightMatrix class stores the weights of K strategies as a struct of arrays,
+ * one contiguous column of K weights per card rank (including a zero column for the joker).
+ *
+ * Counting a card with all strategies is then a single element-wise addition of one column, which the
+ * compiler vectorizes, so the running counts of every strategy over a shoe cost one pass.
+ */
+class WeightMatrix {
+public:
+    /**
+     * @brief Constructs an empty matrix.
+     */
+    WeightMatrix() = default;
+
+    /**
+     * @brief Constructs the matrix of the given strategies, in the given order.
+     * @param strategies The strategies to count with.
+     */
+    explicit WeightMatrix(const QVector<Strategy *> &strategies);
+
+    /**
+     * @brief Returns the number of strategies K.
+     * @return The number of strategies.
+     */
+    qint32 strategyCount() const;
+
+    /**
+     * @brief Returns the distance between the counts of two consecutive positions in a trajectory,
+     * K padded to a multiple of the vector width.
+     * @return The stride of the trajectories.
+     */
+    qint32 stride() const;
+
+    /**
+     * @brief Returns the row of the given strategy.
+     * @param strategy The strategy to look up.
+     * @return The index of the strategy, or -1 if it is not part of the matrix.
+     */
+    qint32 indexOf(const Strategy *strategy) const;
+
+    /**
+     * @brief Returns the weights of all strategies for a card rank.
+     * @param rank The rank of the card, Cards::Rank::Joker to Cards::Rank::King.
+     * @return The column of stride() weights.
+     */
+    const qint32 *column(qint32 rank) const;
+
+    /**
+     * @brief Computes the running counts of all strategies after every card of a shoe in a single pass.
+     * @param cards The IDs of the cards in dealing order.
+     * @return The counts, position-major: the count of strategy k after p cards is at p * stride() + k,
+     * for p from 0 to the number of cards.
+     */
+    QVector<qint32> trajectories(const QVector<qint32> &cards) const;
+
+private:
+    static constexpr qint32 rankCount = 14; ///< The number of ranks, the joker and ace to king.
+    static constexpr qint32 vectorWidth = 8; ///< The number of weights padded to, eight 32-bit lanes.
+
+    qint32 _strategyCount = 0; ///< The number of strategies K.
+    qint32 _stride = 0; ///< K rounded up to a multiple of vectorWidth.
+    QVector<qint32> columns; ///< The weights, rankCount columns of stride() values.
+    QVector<const Strategy *> strategies; ///< The strategies in row order.
+};
+
+#endif //CARD_COUNTER_WEIGHTMATRIX_HPP
@@ -0,0 +1,114 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QTimer>
+#include <QtMath>
+// own
+#include "dealscheduler.hpp"
+
+constexpr double DealScheduler::maxCardsPerSecond;
+
+DealScheduler::DealScheduler(QObject *parent) : QObject(parent), interval(300 * 1000000LL) {
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &DealScheduler::onTimeout);
+    clock.start();
+}
+
+double DealScheduler::Jitter::stddev() const {
+    return ticks > 1 ? qSqrt(m2 / double(ticks - 1)) : 0;
+}
+
+void DealScheduler::setCardsPerSecond(double cardsPerSecond) {
+    cardsPerSecond = qBound(0.01, cardsPerSecond, maxCardsPerSecond);
+    setInterval(qRound64(1e9 / cardsPerSecond));
+}
+
+void DealScheduler::setInterval(qint64 nsecs) {
+    interval = qMax(qint64(0), nsecs);
+    if (running) {
+        start();
+    }
+}
+
+double DealScheduler::getCardsPerSecond() const {
+    return interval ? 1e9 / double(interval) : 0;
+}
+
+void DealScheduler::start() {
+    running = true;
+    deadline = clock.nsecsElapsed() + interval;
+    arm();
+}
+
+void DealScheduler::stop() {
+    running = false;
+    timer->stop();
+}
+
+bool DealScheduler::isActive() const {
+    return running;
+}
+
+DealScheduler::Jitter DealScheduler::getJitter() const {
+    return jitter;
+}
+
+void DealScheduler::resetJitter() {
+    jitter = Jitter();
+}
+
+void DealScheduler::arm() {
+    qint64 remaining = deadline - clock.nsecsElapsed();
+    // QTimer has millisecond resolution, round up so that ticks are never early
+    timer->start(remaining > 0 ? qint32((remaining + 999999) / 1000000) : 0);
+}
+
+void DealScheduler::onTimeout() {
+    qint64 now = clock.nsecsElapsed();
+    qint64 lateness = now - deadline;
+    if (lateness < 0) {
+        // woke up too early, wait for the rest of the interval
+        arm();
+        return;
+    }
+
+    jitter.ticks++;
+    double delta = double(lateness) - jitter.mean;
+    jitter.mean += delta / double(jitter.ticks);
+    jitter.m2 += delta * (double(lateness) - jitter.mean);
+    jitter.max = qMax(jitter.max, lateness);
+
+    deadline += interval;
+    if (now - deadline > interval) {
+        if (interval) {
+            jitter.skipped++;
+        }
+        deadline = now + interval;
+    }
+
+    emit tick();
+    // the receiver may have stopped or restarted the schedule
+    if (running && !timer->isActive()) {
+        arm();
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_DEALSCHEDULER_HPP
+#define CARD_COUNTER_DEALSCHEDULER_HPP
+
+// Qt
+#include <QObject>
+#include <QElapsedTimer>
+
+class QTimer;
+
+/**
+ * @brief The DealScheduler class paces the abstract dealer at a steady number of cards per second.
+ *
+ * Ticks are planned on a monotonic clock as start + n * interval and every single-shot precise timer
+ * is armed for the remaining time to the next deadline, so the lateness of one tick does not add up
+ * over the shoe. When the event loop falls behind by more than one interval, the schedule is restarted
+ * from the current time instead of dealing a burst of cards.
+ */
+class DealScheduler : public QObject {
+Q_OBJECT
+public:
+    /**
+     * @brief The statistics of the tick lateness against the planned deadlines.
+     */
+    struct Jitter {
+        qint64 ticks = 0; ///< The number of ticks measured.
+        qint64 skipped = 0; ///< The number of times the schedule was restarted after falling behind.
+        double mean = 0; ///< The mean lateness in nanoseconds.
+        double m2 = 0; ///< The sum of squared differences from the mean (Welford).
+        qint64 max = 0; ///< The largest lateness in nanoseconds.
+
+        /**
+         * @brief Returns the standard deviation of the lateness.
+         * @return The standard deviation in nanoseconds.
+         */
+        double stddev() const;
+    };
+
+    static constexpr double maxCardsPerSecond = 30; ///< The fastest rate allowed by setCardsPerSecond.
+
+    /**
+     * @brief Constructs a stopped scheduler dealing 1000 / 300 cards per second.
+     * @param parent The parent object.
+     */
+    explicit DealScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the dealing rate.
+     * @param cardsPerSecond The number of ticks per second, clamped to (0, maxCardsPerSecond].
+     */
+    void setCardsPerSecond(double cardsPerSecond);
+
+    /**
+     * @brief Sets the interval between two ticks without the rate limit, e.g. for benchmarks.
+     * @param nsecs The interval in nanoseconds, 0 ticks on every event loop iteration.
+     */
+    void setInterval(qint64 nsecs);
+
+    /**
+     * @brief Returns the dealing rate.
+     * @return The number of ticks per second, or 0 if the interval is 0.
+     */
+    double getCardsPerSecond() const;
+
+    /**
+     * @brief Starts dealing, the first tick comes after one interval. Restarts a running schedule.
+     */
+    void start();
+
+    /**
+     * @brief Stops dealing.
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether the scheduler is dealing.
+     * @return True if the scheduler is running, false otherwise.
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Returns the recorded tick lateness statistics.
+     * @return The jitter statistics since the last reset.
+     */
+    Jitter getJitter() const;
+
+    /**
+     * @brief Clears the recorded tick lateness statistics.
+     */
+    void resetJitter();
+
+signals:
+
+    /**
+     * @brief Emitted when the next card should be dealt.
+     */
+    void tick();
+
+private Q_SLOTS:
+
+    void onTimeout();
+
+private:
+    /**
+     * @brief Arms the timer for the time remaining to the next deadline.
+     */
+    void arm();
+
+    QTimer *timer; ///< The single-shot precise timer waking the scheduler up.
+    QElapsedTimer clock; ///< The monotonic clock the deadlines refer to.
+    qint64 interval; ///< The interval between two ticks in nanoseconds.
+    qint64 deadline = 0; ///< The planned time of the next tick in nanoseconds.
+    bool running = false; ///< Whether the scheduler is dealing.
+    Jitter jitter; ///< The tick lateness statistics.
+};
+
+#endif //CARD_COUNTER_DEALSCHEDULER_HPP
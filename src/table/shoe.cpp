@@ -0,0 +1,80 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// own
+#include "shoe.hpp"
+#include "src/strategy/strategy.hpp"
+#include "src/widgets/cards.hpp"
+
+Shoe::Shoe(const QList<qint32> &cards) : _cards(cards.toVector()) {
+}
+
+qint32 Shoe::size() const {
+    return _cards.size();
+}
+
+qint32 Shoe::position() const {
+    return _position;
+}
+
+bool Shoe::finished() const {
+    return _position >= _cards.size();
+}
+
+qint32 Shoe::next() {
+    return _cards[_position++];
+}
+
+qint32 Shoe::cardAt(qint32 position) const {
+    return _cards[position];
+}
+
+void Shoe::seek(qint32 position) {
+    _position = qBound(0, position, _cards.size());
+}
+
+void Shoe::setStrategy(Strategy *strategy) {
+    if (!strategy) {
+        trajectory.clear();
+        return;
+    }
+    trajectory.resize(_cards.size() + 1);
+    qint32 count = 0;
+    trajectory[0] = 0;
+    for (qint32 i = 0; i < _cards.size(); i++) {
+        qint32 rank = Cards::getRank(_cards[i]);
+        if (rank != Cards::Rank::Joker) {
+            count += strategy->getWeights(rank - Cards::Rank::Ace);
+        }
+        trajectory[i + 1] = count;
+    }
+}
+
+qint32 Shoe::countAt(qint32 position) const {
+    return trajectory.isEmpty() ? 0 : trajectory[position];
+}
+
+qint32 Shoe::currentCount() const {
+    return countAt(_position);
+}
+
+bool Shoe::verify(qint32 position, qint32 answer) const {
+    return countAt(position) == answer;
+}
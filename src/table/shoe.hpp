@@ -0,0 +1,122 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_SHOE_HPP
+#define CARD_COUNTER_SHOE_HPP
+
+// Qt
+#include <QList>
+#include <QVector>
+
+class Strategy;
+
+/**
+ * @brief The Shoe class holds the shuffled cards of a table slot together with the running-count
+ * trajectory of its strategy.
+ *
+ * The trajectory is the prefix sum of the card weights of the selected strategy, one count per position,
+ * so the running count at any position, skipping and rewinding are constant-time lookups. Switching the
+ * strategy recomputes the trajectory in a single pass over the shoe.
+ */
+class Shoe {
+public:
+    /**
+     * @brief Constructs an empty shoe.
+     */
+    Shoe() = default;
+
+    /**
+     * @brief Constructs a shoe with the given cards, positioned before the first card.
+     * @param cards The IDs of the shuffled cards.
+     */
+    explicit Shoe(const QList<qint32> &cards);
+
+    /**
+     * @brief Returns the number of cards in the shoe.
+     * @return The number of cards.
+     */
+    qint32 size() const;
+
+    /**
+     * @brief Returns the number of cards already picked up.
+     * @return The current position.
+     */
+    qint32 position() const;
+
+    /**
+     * @brief Checks whether all cards were picked up.
+     * @return True if no card is left, false otherwise.
+     */
+    bool finished() const;
+
+    /**
+     * @brief Picks up the next card.
+     * @return The ID of the card.
+     */
+    qint32 next();
+
+    /**
+     * @brief Returns the card at the given position in dealing order.
+     * @param position The index of the card, in [0, size()).
+     * @return The ID of the card.
+     */
+    qint32 cardAt(qint32 position) const;
+
+    /**
+     * @brief Moves to the given position, i.e. the number of cards picked up.
+     * @param position The new position, clamped to [0, size()].
+     */
+    void seek(qint32 position);
+
+    /**
+     * @brief Selects the strategy the running count is reported for and computes its trajectory.
+     * Has to be called again when the weights of the strategy change.
+     * @param strategy The strategy to count with, or nullptr to report zero.
+     */
+    void setStrategy(Strategy *strategy);
+
+    /**
+     * @brief Returns the running count after the given number of cards.
+     * @param position The number of cards picked up, in [0, size()].
+     * @return The running count of the current strategy.
+     */
+    qint32 countAt(qint32 position) const;
+
+    /**
+     * @brief Returns the running count at the current position.
+     * @return The running count of the current strategy.
+     */
+    qint32 currentCount() const;
+
+    /**
+     * @brief Checks an answer against the running count at the given position.
+     * @param position The number of cards picked up.
+     * @param answer The running count given by the user.
+     * @return True if the answer is correct, false otherwise.
+     */
+    bool verify(qint32 position, qint32 answer) const;
+
+private:
+    QVector<qint32> _cards; ///< The IDs of the cards in dealing order.
+    qint32 _position = 0; ///< The number of cards picked up.
+    QVector<qint32> trajectory; ///< The running count after every position, empty without a strategy.
+};
+
+#endif //CARD_COUNTER_SHOE_HPP
@@ -0,0 +1,72 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+
+// Qt
+#include <QVBoxLayout>
+#include <QDialogButtonBox>
+#include <QPushButton>
+// KF
+#include <KLocalizedString>
+// own
+#include "shoereview.hpp"
+#include "shoe.hpp"
+#include "src/widgets/cards.hpp"
+#include "src/widgets/cardtheme.hpp"
+#include "src/widgets/carousel.hpp"
+
+ShoeReview::ShoeReview(QSvgRenderer *renderer, QWidget *parent) : QDialog(parent), m_renderer(renderer) {
+    setWindowTitle(i18n("Dealt Cards"));
+    setModal(true);
+
+    carousel = new Carousel(CardTheme::forRenderer(renderer)->cardSize());
+    carousel->setMinimumSize(480, 200);
+
+    auto *dialogButtons = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(dialogButtons, &QDialogButtonBox::rejected, this, &ShoeReview::reject);
+    rewindButton = dialogButtons->addButton(i18n("&Rewind Here"), QDialogButtonBox::ActionRole);
+    rewindButton->setIcon(QIcon::fromTheme("media-seek-backward"));
+    rewindButton->setToolTip(i18n("Deal again from the first card shown"));
+    connect(rewindButton, &QPushButton::clicked, this, [=]() {
+        if (carousel->count()) {
+            emit rewound(carousel->currentIndex());
+        }
+        accept();
+    });
+
+    auto *boxLayout = new QVBoxLayout(this);
+    boxLayout->addWidget(carousel);
+    boxLayout->addWidget(dialogButtons);
+}
+
+void ShoeReview::review(const Shoe &shoe) {
+    dealt.resize(shoe.position());
+    for (qint32 i = 0; i < dealt.size(); i++) {
+        dealt[i] = shoe.cardAt(i);
+    }
+    carousel->setItems(dealt.size(), [=]() { return new Cards(m_renderer); }, [=](QWidget *view, qint32 index) {
+        static_cast<Cards *>(view)->setId(dealt[index]);
+        view->update();
+    });
+}
+
+void ShoeReview::setRewindEnabled(bool enabled) {
+    rewindButton->setEnabled(enabled);
+}
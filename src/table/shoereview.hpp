@@ -0,0 +1,80 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+
+#ifndef CARD_COUNTER_SHOEREVIEW_HPP
+#define CARD_COUNTER_SHOEREVIEW_HPP
+
+// Qt
+#include <QDialog>
+#include <QVector>
+
+class QSvgRenderer;
+
+class QPushButton;
+
+class Carousel;
+
+class Shoe;
+
+/**
+ * @brief The ShoeReview class lets the user browse the cards a table slot has dealt so far.
+ *
+ * The cards are items of a Carousel, so only the visible ones have views however deep the shoe is dealt. The user can
+ * rewind the shoe to the first card shown, which is then dealt again.
+ */
+class ShoeReview : public QDialog {
+Q_OBJECT
+public:
+    /**
+     * @brief Constructs an empty review.
+     * @param renderer The SVG renderer of the card theme.
+     * @param parent The parent widget.
+     */
+    explicit ShoeReview(QSvgRenderer *renderer, QWidget *parent = nullptr);
+
+    /**
+     * @brief Shows the cards picked up from the given shoe, starting with the first one.
+     * @param shoe The shoe of the table slot.
+     */
+    void review(const Shoe &shoe);
+
+    /**
+     * @brief Enables or disables rewinding, e.g. while a question about the current card is open.
+     * @param enabled Whether the shoe may be rewound.
+     */
+    void setRewindEnabled(bool enabled);
+
+signals:
+
+    /**
+     * @brief Emitted when the user rewinds the shoe.
+     * @param position The new position of the shoe, i.e. the index of the card dealt next.
+     */
+    void rewound(qint32 position);
+
+private:
+    QSvgRenderer *m_renderer; ///< The SVG renderer the views of the cards are created with.
+    Carousel *carousel; ///< The carousel showing the cards.
+    QPushButton *rewindButton; ///< The button rewinding the shoe to the first card shown.
+    QVector<qint32> dealt; ///< The IDs of the cards picked up, in dealing order.
+};
+
+#endif //CARD_COUNTER_SHOEREVIEW_HPP
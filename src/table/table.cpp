@@ -23,16 +23,24 @@
 #include <QSvgRenderer>
 #include <QStandardPaths>
 #include <QtMath>
-#include <QTimer>
 #include <QRandomGenerator>
+#include <QElapsedTimer>
+// KF
+#include <KConfigGroup>
+#include <KSharedConfig>
 // own
 #include "table.hpp"
 #include "tableslot.hpp"
+#include "dealscheduler.hpp"
 #include "src/strategy/strategyinfo.hpp"
+#include "src/perf/tracer.hpp"
+#include "src/perf/framestats.hpp"
+#include "src/widgets/perfoverlay.hpp"
+#include "src/widgets/cardtheme.hpp"
 
 Table::Table(QWidget *parent) : QWidget(parent) {
-    countdown = new QTimer(this);
-    connect(countdown, &QTimer::timeout, this, &Table::pickUpCards);
+    countdown = new DealScheduler(this);
+    connect(countdown, &DealScheduler::tick, this, &Table::pickUpCards);
 
     setRenderer("tigullio-international");
     strategyInfo = new StrategyInfo(renderer);
@@ -50,25 +58,43 @@ void Table::onTableSlotActivated() {
 }
 
 void Table::addNewTableSlot(bool isActive) {
-    auto *tableSlot = new TableSlot(strategyInfo, renderer, isActive, this);
+    TableSlot *tableSlot;
+    if (pool.empty()) {
+        tableSlot = new TableSlot(strategyInfo, renderer, isActive, this);
+        connect(tableSlot, &TableSlot::tableSlotActivated, this, &Table::onTableSlotActivated);
+        connect(tableSlot, &TableSlot::tableSlotFinished, this, &Table::onTableSlotFinished);
+        connect(tableSlot, &TableSlot::tableSlotRemoved, this, &Table::onTableSlotRemoved);
+        connect(tableSlot, &TableSlot::tableSlotReshuffled, this, &Table::onTableSlotReshuffled);
+        connect(tableSlot, &TableSlot::userQuizzed, this, &Table::onUserQuizzed);
+        connect(tableSlot, &TableSlot::userAnswered, this, &Table::onUserAnswered);
+        connect(tableSlot, &TableSlot::answerTimed, this, &Table::onAnswerTimed);
+        connect(tableSlot, &TableSlot::userSkipped, this, &Table::onUserSkipped);
+        connect(tableSlot, &TableSlot::swapTargetSelected, this, &Table::onSwapTargetSelected);
+        connect(tableSlot, &TableSlot::strategyInfoAssist, this, &Table::onStrategyInfoAssist);
+        connect(this, &Table::gamePaused, tableSlot, &TableSlot::onGamePaused);
+        connect(this, &Table::tableSlotResized, tableSlot,
+                [tableSlot](QSize newFixedSize) { tableSlot->setFixedSize(newFixedSize); });
+        connect(this, &Table::canRemove, tableSlot, &TableSlot::onCanRemove);
+    } else {
+        // pooled slots are already reset to the fake state
+        tableSlot = pool.takeLast();
+        if (isActive) {
+            tableSlot->reset(true);
+        }
+    }
     if (isActive) {
         available.insert(items.size());
     }
-    connect(tableSlot, &TableSlot::tableSlotActivated, this, &Table::onTableSlotActivated);
-    connect(tableSlot, &TableSlot::tableSlotFinished, this, &Table::onTableSlotFinished);
-    connect(tableSlot, &TableSlot::tableSlotRemoved, this, &Table::onTableSlotRemoved);
-    connect(tableSlot, &TableSlot::tableSlotReshuffled, this, &Table::onTableSlotReshuffled);
-    connect(tableSlot, &TableSlot::userQuizzed, this, &Table::onUserQuizzed);
-    connect(tableSlot, &TableSlot::userAnswered, this, &Table::onUserAnswered);
-    connect(tableSlot, &TableSlot::swapTargetSelected, this, &Table::onSwapTargetSelected);
-    connect(tableSlot, &TableSlot::strategyInfoAssist, this, &Table::onStrategyInfoAssist);
-    connect(this, &Table::gamePaused, tableSlot, &TableSlot::onGamePaused);
-    connect(this, &Table::tableSlotResized, tableSlot,
-            [tableSlot](QSize newFixedSize) { tableSlot->setFixedSize(newFixedSize); });
-    connect(this, &Table::canRemove, tableSlot, &TableSlot::onCanRemove);
     items.push_back(tableSlot);
 }
 
+void Table::releaseTableSlot(TableSlot *tableSlot) {
+    tableSlot->hide();
+    layout->removeWidget(tableSlot);
+    tableSlot->reset();
+    pool.push_back(tableSlot);
+}
+
 void Table::onTableSlotFinished() {
     auto *tableSlot = qobject_cast<TableSlot *>(sender());
     available.remove(layout->indexOf(tableSlot));
@@ -77,9 +103,11 @@ void Table::onTableSlotFinished() {
 
 void Table::onTableSlotRemoved() {
     auto *tableSlot = qobject_cast<TableSlot *>(sender());
-    items.remove(layout->indexOf(tableSlot));
-    available.remove(layout->indexOf(tableSlot));
-    jokers.remove(layout->indexOf(tableSlot));
+    qint32 idx = layout->indexOf(tableSlot);
+    items.remove(idx);
+    available.remove(idx);
+    jokers.remove(idx);
+    releaseTableSlot(tableSlot);
     calculateNewColumnCount(size(), bounds.size(), items.count());
     emit canRemove(available.size() > tableSlotCountLimit);
 }
@@ -97,14 +125,22 @@ void Table::onUserQuizzed() {
 }
 
 void Table::onUserAnswered(bool correct) {
+    onUserSkipped();
+    emit scoreUpdate(correct);
+}
+
+void Table::onUserSkipped() {
     auto *tableSlot = qobject_cast<TableSlot *>(sender());
     jokers.remove(layout->indexOf(tableSlot));
     available.insert(layout->indexOf(tableSlot));
     if (jokers.empty()) {
-        countdown->stop();
-        countdown->start(300);
+        countdown->start();
     }
-    emit scoreUpdate(correct);
+}
+
+void Table::onAnswerTimed(qint64 nsecs) {
+    auto *tableSlot = qobject_cast<TableSlot *>(sender());
+    answerStats.record({tableSlot->getStrategyName(), tableSlot->getDeckCount(), levelName}, nsecs);
 }
 
 void Table::calculateNewColumnCount(const QSizeF &tableSize, const QSizeF &aspectRatio, int itemCount) {
@@ -123,6 +159,7 @@ void Table::calculateNewColumnCount(const QSizeF &tableSize, const QSizeF &aspec
 }
 
 void Table::reorganizeTable(qint32 newColumnCount, double newScale) {
+    CC_TRACE_SPAN("Table::reorganizeTable");
     // Remove all items from the layout
     while (layout->count()) {
         QLayoutItem *item = layout->takeAt(0);
@@ -155,6 +192,9 @@ void Table::onSwapTargetSelected() {
 }
 
 void Table::pickUpCards() {
+    CC_TRACE_SPAN("Table::pickUpCards");
+    QElapsedTimer timer;
+    timer.start();
 //    qDebug() << available;
     if (available.empty()) {
         countdown->stop();
@@ -176,50 +216,62 @@ void Table::pickUpCards() {
     available.unite(picked);
     // emit deHighlighting
     picked.clear();
+    if (FrameStats::instance()->isEnabled()) {
+        FrameStats::instance()->addTick(timer.nsecsElapsed());
+    }
 }
 
 void Table::setRenderer(const QString &cardTheme) {
-    renderer = new QSvgRenderer(
-            QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-                                   QString("carddecks/svg-%1/%1.svgz").arg(cardTheme)));
-    bounds = renderer->boundsOnElement("back");
+    const QString path = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
+                                                QString("carddecks/svg-%1/%1.svgz").arg(cardTheme));
+    renderer = new QSvgRenderer(path);
+    bounds = CardTheme::load(renderer, path)->element(CardTheme::Back).bounds;
 }
 
 void Table::createNewGame(KgDifficultyLevel::StandardLevel level) {
     countdown->stop();
     launching = true;
     while (!items.empty()) {
-        TableSlot *last = items.last();
-        last->hide();
-        items.pop_back();
-        delete last;
+        releaseTableSlot(items.takeLast());
     }
     available.clear();
     jokers.clear();
+    swapTarget.clear();
+    QString levelKey = QStringLiteral("Default");
     switch (level) {
         case KgDifficultyLevel::Easy:
             // tableSlotsCount: 1+
             // cardPickUpsAtTime: 1
             tableSlotCountLimit = 1;
+            levelKey = QStringLiteral("Easy");
             break;
         case KgDifficultyLevel::Medium:
             // tableSlotsCount: 2+
             // cardPickUpsAtTime: 2
             tableSlotCountLimit = 2;
+            levelKey = QStringLiteral("Medium");
             break;
         case KgDifficultyLevel::Hard:
             // tableSlotsCount: 4+
             // cardPickUpsAtTime: 4
             tableSlotCountLimit = 4;
+            levelKey = QStringLiteral("Hard");
             break;
         case KgDifficultyLevel::Custom: // Nightmare
             // tableSlotsCount: 6+
             // cardPickUpsAtTime: all
             tableSlotCountLimit = 6;
+            levelKey = QStringLiteral("Nightmare");
             break;
         default:
             break;
     }
+    // cards per second for every level, e.g. "Hard=10" in the CCDealing group
+    KConfigGroup dealingGroup(KSharedConfig::openConfig(), "CCDealing");
+    countdown->setCardsPerSecond(dealingGroup.readEntry(levelKey, 1000.0 / 300));
+    countdown->resetJitter();
+    levelName = levelKey;
+    answerStats.clear();
     while (items.count() < tableSlotCountLimit) {
         addNewTableSlot(true);
     }
@@ -233,7 +285,7 @@ void Table::pause(bool paused) {
         TableSlot *last = items.last();
         if (last->isFake()) {
             items.pop_back();
-            delete last;
+            releaseTableSlot(last);
             calculateNewColumnCount(size(), bounds.size(), layout->count());
         }
     }
@@ -241,8 +293,7 @@ void Table::pause(bool paused) {
     if (paused) {
         countdown->stop();
     } else if (jokers.empty()) {
-        countdown->stop();
-        countdown->start(300);
+        countdown->start();
     }
 }
 
@@ -255,3 +306,29 @@ void Table::resizeEvent(QResizeEvent *event) {
 void Table::onStrategyInfoAssist() {
     strategyInfo->show();
 }
+
+void Table::setDealInterval(qint32 msec) {
+    countdown->setInterval(qMax(0, msec) * 1000000LL);
+}
+
+DealScheduler *Table::getDealScheduler() const {
+    return countdown;
+}
+
+QVector<TableSlot *> Table::getTableSlots() const {
+    return items;
+}
+
+void Table::setOverlayVisible(bool visible) {
+    if (!overlay) {
+        if (!visible) {
+            return;
+        }
+        overlay = new PerfOverlay(this);
+    }
+    overlay->setVisible(visible);
+}
+
+const AnswerStats &Table::getAnswerStats() const {
+    return answerStats;
+}
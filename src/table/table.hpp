@@ -25,6 +25,8 @@
 #include <QWidget>
 #include <QSet>
 #include <KgDifficulty>
+// own
+#include "src/perf/answerstats.hpp"
 
 class QGridLayout;
 
@@ -34,6 +36,10 @@ class TableSlot;
 
 class StrategyInfo;
 
+class PerfOverlay;
+
+class DealScheduler;
+
 class Table : public QWidget {
 Q_OBJECT
 public:
@@ -58,6 +64,41 @@ public:
      */
     void pause(bool paused);
 
+    /**
+     * @brief Sets the delay between two card pick-ups until the next game, bypassing the rate limit.
+     *
+     * @param msec The delay in milliseconds, 0 deals as fast as the event loop allows.
+     */
+    void setDealInterval(qint32 msec);
+
+    /**
+     * @brief Returns the table slots currently placed on the table.
+     *
+     * @return A vector containing the table slots in layout order.
+     */
+    QVector<TableSlot *> getTableSlots() const;
+
+    /**
+     * @brief Shows or hides the performance overlay on top of the table.
+     *
+     * @param visible A boolean indicating whether the overlay should be visible.
+     */
+    void setOverlayVisible(bool visible);
+
+    /**
+     * @brief Returns the scheduler pacing the card pick-ups.
+     *
+     * @return The deal scheduler of the table.
+     */
+    DealScheduler *getDealScheduler() const;
+
+    /**
+     * @brief Returns the joker answer latencies of the current game.
+     *
+     * @return The answer statistics, cleared by createNewGame.
+     */
+    const AnswerStats &getAnswerStats() const;
+
 signals:
 
     /**
@@ -112,6 +153,17 @@ private Q_SLOTS:
      */
     void onUserAnswered(bool correct);
 
+    /**
+     * @brief onAnswerTimed - Slot for recording how long the user needed to answer a quiz question.
+     * @param nsecs The answer latency in nanoseconds.
+     */
+    void onAnswerTimed(qint64 nsecs);
+
+    /**
+     * @brief onUserSkipped - Slot for handling a quiz question skipped by the user.
+     */
+    void onUserSkipped();
+
     void onSwapTargetSelected();
 
     void pickUpCards();
@@ -128,6 +180,12 @@ private:
      */
     void addNewTableSlot(bool isActive = false);
 
+    /**
+     * @brief releaseTableSlot - Takes a TableSlot off the table and keeps it in the pool for later reuse.
+     * @param tableSlot The TableSlot to release.
+     */
+    void releaseTableSlot(TableSlot *tableSlot);
+
     /**
      * @brief setRenderer - Sets the renderer used to render the table slots.
      * @param cardTheme The name of the card theme to use.
@@ -160,16 +218,20 @@ private:
     QGridLayout *layout; ///< The grid layout used to organize the table slots.
     QSvgRenderer *renderer{}; ///< The SVG renderer used to draw the cards.
     QRectF bounds; ///< The bounding rectangle of the SVG image used to draw the cards.
-    QTimer *countdown; ///< The timer used for the countdown feature.
+    DealScheduler *countdown; ///< The scheduler pacing the card pick-ups.
     StrategyInfo *strategyInfo; ///< The strategy info dialog.
+    PerfOverlay *overlay{}; ///< The performance overlay, created when it is shown the first time.
 
     bool launching{}; ///< A boolean indicating whether the game is launching.
     qint32 columnCount = -1; ///< The number of columns in the table grid.
     qint32 tableSlotCountLimit{}; ///< The maximum number of table slots allowed on the table.
+    QString levelName; ///< The name of the difficulty level of the current game.
+    AnswerStats answerStats; ///< The joker answer latencies of the current game.
     qreal scale = -1; ///< The scale of the table slots.
 
     QVector<int> swapTarget; ///< The current swap target.
     QVector<TableSlot *> items; ///< The list of table slots on the table.
+    QVector<TableSlot *> pool; ///< The released table slots waiting to be reused.
     QSet<qint32> jokers; ///< The set of jokers on the table.
     QSet<qint32> available; ///< The set of available table slots.
 
@@ -26,19 +26,24 @@
 #include <QPushButton>
 #include <QComboBox>
 #include <QCheckBox>
+#include <QSignalBlocker>
 // KF
 #include <KLocalizedString>
 // own
 #include "tableslot.hpp"
+#include "shoereview.hpp"
 #include "src/widgets/cards.hpp"
+#include "src/widgets/cardtheme.hpp"
 #include "src/strategy/strategy.hpp"
 #include "src/strategy/strategyinfo.hpp"
+#include "src/strategy/strategymodel.hpp"
+#include "src/perf/tracer.hpp"
 // own widgets
 #include "src/widgets/base/label.hpp"
 #include "src/widgets/base/frame.hpp"
 
 TableSlot::TableSlot(StrategyInfo *strategies, QSvgRenderer *renderer, bool isActive, QWidget *parent)
-        : Cards(renderer, parent), _strategies(strategies) {
+        : Cards(renderer, parent), m_renderer(renderer), _strategies(strategies) {
 
     // QLabels:
     messageLabel = new CCLabel(i18n("TableSlot Weight: 0"));
@@ -49,7 +54,7 @@ TableSlot::TableSlot(StrategyInfo *strategies, QSvgRenderer *renderer, bool isAc
 
     // QComboBoxes:
     strategyBox = new QComboBox();
-    onNewStrategy();
+    strategyBox->setModel(strategies->getSlotModel());
     connect(strategies, &StrategyInfo::newStrategy, this, &TableSlot::onNewStrategy);
     connect(strategyBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &TableSlot::onStrategyChanged);
@@ -81,7 +86,7 @@ TableSlot::TableSlot(StrategyInfo *strategies, QSvgRenderer *renderer, bool isAc
 
     auto *skipButton = new QPushButton(QIcon::fromTheme("media-skip-forward"), i18n("&Skip"));
     skipButton->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
-// todo:    connect(skipButton, &QPushButton::clicked, this, &TableSlot::skipping);
+    connect(skipButton, &QPushButton::clicked, this, &TableSlot::skipping);
 
     auto *strategyInfoButton = new QPushButton(QIcon::fromTheme("kt-info-widget"), i18n("&Info"));
     strategyInfoButton->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
@@ -101,6 +106,11 @@ TableSlot::TableSlot(StrategyInfo *strategies, QSvgRenderer *renderer, bool isAc
     swapButton->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
     connect(swapButton, &QPushButton::clicked, this, &TableSlot::swapTargetSelected);
 
+    reviewButton = new QPushButton(QIcon::fromTheme("view-list-icons"), i18n("Re&view"));
+    reviewButton->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
+    connect(reviewButton, &QPushButton::clicked, this, &TableSlot::reviewShoe);
+    reviewButton->hide();
+
     // QFormLayouts:
     auto *settings = new QFormLayout(settingsFrame);
     settings->setFormAlignment(Qt::AlignCenter);
@@ -132,6 +142,7 @@ TableSlot::TableSlot(StrategyInfo *strategies, QSvgRenderer *renderer, bool isAc
     controlLayout->addWidget(closeButton);
     controlLayout->addWidget(refreshButton);
     controlLayout->addWidget(swapButton);
+    controlLayout->addWidget(reviewButton);
 
     boxLayout->addWidget(strategyHintLabel);
     boxLayout->addStretch();
@@ -144,21 +155,26 @@ TableSlot::TableSlot(StrategyInfo *strategies, QSvgRenderer *renderer, bool isAc
 }
 
 void TableSlot::onGamePaused(bool paused) {
+    if (fake) {
+        // fake slots are only left over in the pool of the table
+        return;
+    }
     if (!settingsFrame->isHidden()) {
-        cards = shuffleCards(deckCount->value());
+        newShoe();
         refreshButton->show();
+        reviewButton->show();
 //        swapButton->hide();
         setId(-1);
         settingsFrame->hide();
     }
     if (paused) {
         answerFrame->hide();
-        setName("blue_back");
+        setElement(CardTheme::BlueBack);
         controlFrame->show();
     } else {
         controlFrame->hide();
         if (isJoker()) {
-            setName(getCardNameByCurrentId());
+            showFace();
             userQuizzing();
         }
     }
@@ -170,8 +186,9 @@ bool TableSlot::isFake() const {
 }
 
 void TableSlot::pickUpCard() {
-    if (cards.empty()) {
-        setName("back");
+    CC_TRACE_SPAN("TableSlot::pickUpCard");
+    if (shoe.finished()) {
+        setElement(CardTheme::Back);
         emit tableSlotFinished();
         settingsFrame->show();
         controlFrame->show();
@@ -181,43 +198,99 @@ void TableSlot::pickUpCard() {
 //    if (isJoker()){
 //        messageLabel->hide();
 //    }
-    setId(cards.front());
-    setName(getCardNameByCurrentId());
-    cards.pop_front();
+    setId(shoe.next());
     if (!messageLabel->isHidden()) {
         messageLabel->hide();
     }
     update();
-    indexLabel->setText(i18n("%1/%2", deckCount->value() * 54 - cards.size(), deckCount->value() * 54));
+    indexLabel->setText(i18n("%1/%2", shoe.position(), shoe.size()));
     if (isJoker()) {
         userQuizzing();
     } else {
-        currentWeight = _strategy->updateWeight(currentWeight, getCurrentRank());
-        weightLabel->setText(i18n("weight: %1", currentWeight));
+        weightLabel->setText(i18n("weight: %1", shoe.currentCount()));
     }
     // add highlighting
 }
 
 void TableSlot::userQuizzing() {
     answerFrame->show();
+    // the answer time starts with the next paint, when the joker is actually on screen
+    quizPresented = false;
+    quizTimer.invalidate();
     emit userQuizzed();
 }
 
-void TableSlot::userChecking() {
-    messageLabel->setText(i18n("TableSlot Weight: %1", currentWeight));
+void TableSlot::paintEvent(QPaintEvent *event) {
+    Cards::paintEvent(event);
+    if (!quizPresented && !answerFrame->isHidden()) {
+        quizPresented = true;
+        quizTimer.start();
+    }
+}
+
+void TableSlot::revealWeight(const QPalette &palette) {
+    messageLabel->setText(i18n("TableSlot Weight: %1", shoe.currentCount()));
     answerFrame->hide();
-    bool isCorrect = weightBox->value() == currentWeight;
-    messageLabel->setPalette(QPalette(isCorrect ? Qt::green : Qt::red));
+    messageLabel->setPalette(palette);
     messageLabel->show();
+}
+
+void TableSlot::skipping() {
+    revealWeight(QPalette(Qt::gray));
+    quizTimer.invalidate();
+    emit userSkipped();
+}
+
+void TableSlot::userChecking() {
+    bool isCorrect = shoe.verify(shoe.position(), weightBox->value());
+    revealWeight(QPalette(isCorrect ? Qt::green : Qt::red));
+    if (quizTimer.isValid()) {
+        emit answerTimed(quizTimer.nsecsElapsed());
+        quizTimer.invalidate();
+    }
     emit userAnswered(isCorrect);
 }
 
+void TableSlot::newShoe() {
+    shoe = Shoe(shuffleCards(deckCount->value()));
+    shoe.setStrategy(_strategy);
+}
+
 void TableSlot::reshuffleDeck() {
-    cards = shuffleCards(deckCount->value());
+    newShoe();
     settingsFrame->hide();
     // hide controlFrame if not paused
 }
 
+void TableSlot::reviewShoe() {
+    if (!review) {
+        // most slots are never reviewed, so the dialog is only built on demand
+        review = new ShoeReview(m_renderer, this);
+        connect(review, &ShoeReview::rewound, this, &TableSlot::rewindShoe);
+    }
+    // the table waits for the answer about a joker, which must not be rewound away
+    review->setRewindEnabled(!isJoker());
+    review->review(shoe);
+    review->exec();
+}
+
+void TableSlot::rewindShoe(qint32 position) {
+    bool wasFinished = shoe.finished();
+    shoe.seek(position);
+    setId(shoe.position() > 0 ? shoe.cardAt(shoe.position() - 1) : -1);
+    // the card stays turned over until the next one is picked up
+    setElement(CardTheme::BlueBack);
+    messageLabel->hide();
+    indexLabel->setText(i18n("%1/%2", shoe.position(), shoe.size()));
+    weightLabel->setText(i18n("weight: %1", shoe.currentCount()));
+    if (wasFinished && !shoe.finished()) {
+        settingsFrame->hide();
+        // the table deals from the slot again, like from a reshuffled one
+        emit tableSlotReshuffled();
+    }
+    update();
+}
+
 void TableSlot::onCanRemove(bool canRemove) {
     closeButton->setVisible(canRemove);
 }
@@ -226,26 +299,66 @@ void TableSlot::activate(int value) {
     if (value > 0 && fake) {
         fake = false;
         controlFrame->show();
-        setName("green_back");
-        currentWeight = 0;
+        setElement(CardTheme::GreenBack);
         deckCount->setMinimum(1);
         emit tableSlotActivated();
     }
 }
 
-void TableSlot::onNewStrategy() {
-    QStringList items;
-    for (auto *item: _strategies->getStrategies()) {
-        items.push_back(item->getName());
+void TableSlot::reset(bool isActive) {
+    fake = true;
+    shoe = Shoe();
+    setId(-1);
+    setElement(CardTheme::Back);
+
+    messageLabel->setText(i18n("TableSlot Weight: 0"));
+    messageLabel->hide();
+    indexLabel->setText("0/0");
+    weightLabel->setText("weight: 0");
+
+    answerFrame->hide();
+    controlFrame->hide();
+    settingsFrame->show();
+    refreshButton->hide();
+    reviewButton->hide();
+    closeButton->hide();
+
+    // the table is already listening, so the activation must not be reported
+    QSignalBlocker blocker(deckCount);
+    deckCount->setRange(isActive, 10);
+    deckCount->setValue(isActive);
+    if (isActive) {
+        fake = false;
+        controlFrame->show();
+        setElement(CardTheme::GreenBack);
     }
-    items.pop_back(); // last is fake
-    strategyBox->clear();
-    strategyBox->addItems(items);
+    update();
+}
+
+void TableSlot::setDeckCount(qint32 value) {
+    deckCount->setValue(value);
+}
+
+qint32 TableSlot::getDeckCount() const {
+    return deckCount->value();
+}
+
+QString TableSlot::getStrategyName() const {
+    return _strategy->getName();
+}
+
+void TableSlot::onNewStrategy() {
+    // the combo box follows the shared model, only the strategy of the selected row may have been replaced
+    // or edited, and selecting it again recomputes the trajectory of the shoe
+    onStrategyChanged(strategyBox->currentIndex());
 }
 
 void TableSlot::onStrategyChanged(int index) {
     if (index >= 0) {
-        _strategy = _strategies->getStrategyById(index);
+        _strategy = _strategies->getSlotModel()->strategy(index);
         strategyHintLabel->setText(_strategy->getName());
+        // the counts of the whole shoe so far, as if it had been counted with this strategy from the start
+        shoe.setStrategy(_strategy);
+        weightLabel->setText(i18n("weight: %1", shoe.currentCount()));
     }
 }
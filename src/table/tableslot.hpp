@@ -21,8 +21,11 @@
 #ifndef CARD_COUNTER_TABLESLOT_HPP
 #define CARD_COUNTER_TABLESLOT_HPP
 
+// Qt
+#include <QElapsedTimer>
 // own
 #include "src/widgets/cards.hpp"
+#include "shoe.hpp"
 
 class QSvgRenderer;
 
@@ -42,6 +45,8 @@ class Strategy;
 
 class QComboBox;
 
+class ShoeReview;
+
 /*!
  * \brief The TableSlot class represents the slot on a table that can contain
  * one or multiple shuffled deck of playing cards. The slot can be fake (not contain any deck)
@@ -72,6 +77,33 @@ public:
      */
     void pickUpCard();
 
+    /**
+     * @brief Resets the table slot in place so it can be reused for a new game
+     * without rebuilding its widgets. The chosen strategy and display options are kept.
+     * @param isActive Whether the table slot should be active after the reset
+     */
+    void reset(bool isActive = false);
+
+    /**
+     * @brief Sets the number of standard decks, activating a fake table slot like the spin box does
+     * @param value Number of standard decks in the table slot
+     */
+    void setDeckCount(qint32 value);
+
+    /**
+     * @brief Returns the number of standard decks in the table slot
+     * @return The number of decks
+     */
+    qint32 getDeckCount() const;
+
+    /**
+     * @brief Returns the name of the strategy the table slot is counted with
+     * @return The name of the current strategy
+     */
+    QString getStrategyName() const;
+
+    void paintEvent(QPaintEvent *event) override;
+
 signals:
 
     /**
@@ -110,6 +142,18 @@ signals:
      */
     void userAnswered(bool correct);
 
+    /**
+     * @brief UserSkipped - Signal emitted when the user skipped the question
+     * about the weight of the table slot, the answer is not scored
+     */
+    void userSkipped();
+
+    /**
+     * @brief AnswerTimed - Signal emitted right before userAnswered with the time the user needed
+     * @param nsecs Time from the presentation of the joker on screen to the submit, in nanoseconds
+     */
+    void answerTimed(qint64 nsecs);
+
     /**
      * @brief SwapTargetSelected - Signal emitted when user selects one of two targets for swapping.
      * @note The receiver of this signal should wait for the second target to be selected.
@@ -151,11 +195,27 @@ public Q_SLOTS:
      */
     void userChecking();
 
+    /**
+     * @brief skipping - Slot called when the user skips the question, revealing the weight without scoring.
+     */
+    void skipping();
+
     /**
      * @brief reshuffleDeck - Slot called when the user wants to reshuffle the deck.
      */
     void reshuffleDeck();
 
+    /**
+     * @brief reviewShoe - Slot called when the user wants to browse the cards dealt so far.
+     */
+    void reviewShoe();
+
+    /**
+     * @brief rewindShoe - Slot called when the user rewinds the shoe to a card dealt before.
+     * @param position The new position of the shoe, i.e. the index of the card dealt next.
+     */
+    void rewindShoe(qint32 position);
+
     /**
      * @brief activate - Slot called when the slot is activated, meaning the number of standard decks is set to a value
      * greater than zero.
@@ -170,11 +230,24 @@ private:
      */
     void userQuizzing();
 
-    QList<qint32> cards; // List of card indices
+    /**
+     * @brief newShoe - Method called to shuffle a new shoe with the selected number of decks.
+     */
+    void newShoe();
+
+    /**
+     * @brief revealWeight - Method called to close the question and show the weight of the slot.
+     * @param palette The colour of the message.
+     */
+    void revealWeight(const QPalette &palette);
+
+    QSvgRenderer *m_renderer; // The object used to render the playing cards
+    Shoe shoe; // Shuffled cards with the running counts of the current strategy
     Strategy *_strategy{}; // Pointer to the current strategy
     StrategyInfo *_strategies; // Pointer to the strategies available in the game
-    qint32 currentWeight = 0; // The current weight of the slot
     bool fake = true; // Flag indicating whether the slot is fake or not
+    bool quizPresented = false; // Flag indicating whether the joker question was painted on screen
+    QElapsedTimer quizTimer; // Monotonic time since the joker question was painted on screen
 
     // UI elements
     CCFrame *answerFrame; // Frame for displaying the answer input and submit button
@@ -192,6 +265,9 @@ private:
     QPushButton *refreshButton; // Button for refreshing the card deck
     QPushButton *swapButton; // Button for swapping the current slot with another
     QPushButton *closeButton; // Button for closing the current slot
+    QPushButton *reviewButton; // Button for browsing the cards dealt so far
+
+    ShoeReview *review{}; // Dialog for browsing the cards dealt so far, created on first use
 
     QComboBox *strategyBox; // Combo box for selecting the current strategy
 };
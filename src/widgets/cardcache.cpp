@@ -0,0 +1,113 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QCoreApplication>
+#include <QPainter>
+#include <QSvgRenderer>
+// own
+#include "cardcache.hpp"
+#include "cardtheme.hpp"
+#include "src/perf/tracer.hpp"
+#include "src/perf/framestats.hpp"
+
+namespace {
+    // a few themes at a few sizes, the file is shared by all instances
+    const unsigned cacheSize = 64 * 1024 * 1024;
+    // a card of about 150 by 210 pixels compressed as a PNG
+    const unsigned expectedItemSize = 32 * 1024;
+    // the cards of a full table at a large size
+    const qint32 cachedKiB = 32 * 1024;
+}
+
+CardCache *CardCache::instance() {
+    static CardCache cache;
+    return &cache;
+}
+
+CardCache::CardCache() : cache(QStringLiteral("card-counter-cards"), cacheSize, expectedItemSize),
+                         pixmaps(cachedKiB) {
+    // the pixmaps are kept here instead, with the device pixel ratio the cached images lose
+    cache.setPixmapCaching(false);
+    settle.setSingleShot(true);
+    settle.setInterval(settleMsecs);
+    QObject::connect(&settle, &QTimer::timeout, [this]() { persist(); });
+    // the cards of the final size are kept for the next launch even if it quits right after a resize
+    QObject::connect(qApp, &QCoreApplication::aboutToQuit, &settle, [this]() {
+        settle.stop();
+        persist();
+    });
+}
+
+QPixmap CardCache::pixmap(const CardTheme *theme, qint32 element, const QSize &size, qreal devicePixelRatio) {
+    const QSize pixels = size * devicePixelRatio;
+    // theme, element, size and ratio packed into one integer, so a lookup in memory builds no string
+    const quint64 key = quint64(theme->serial() & 0xff) << 56 | quint64(element & 0xff) << 48
+                        | quint64(pixels.width() & 0xffff) << 32 | quint64(pixels.height() & 0xffff) << 16
+                        | quint64(qRound(devicePixelRatio * 100) & 0xffff);
+    if (const QPixmap *cached = pixmaps.object(key)) {
+        if (FrameStats::instance()->isEnabled()) {
+            FrameStats::instance()->addPixmapLookup(true);
+        }
+        return *cached;
+    }
+
+    const QString &id = theme->element(element).id;
+    QImage image;
+    bool hit = false;
+    if (theme->fileHash().isEmpty()) {
+        // without the hash of the file, cards of different themes could share a name
+        image = render(theme->renderer(), id, pixels);
+    } else {
+        const QString name = QStringLiteral("%1/%2/%3x%4@%5").arg(theme->fileHash(), id).arg(pixels.width())
+                .arg(pixels.height()).arg(devicePixelRatio);
+        hit = cache.findImage(name, &image);
+        if (!hit) {
+            image = render(theme->renderer(), id, pixels);
+            // the same key without the size, so the sizes passed while resizing replace each other
+            pending.insert(key & ~(quint64(0xffffffff) << 16), {name, image});
+            settle.start();
+        }
+    }
+    if (FrameStats::instance()->isEnabled()) {
+        FrameStats::instance()->addPixmapLookup(hit);
+    }
+    QPixmap pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmaps.insert(key, new QPixmap(pixmap), qMax(1, pixels.width() * pixels.height() * 4 / 1024));
+    return pixmap;
+}
+
+void CardCache::persist() {
+    CC_TRACE_SPAN("CardCache::persist");
+    for (const Pending &card: qAsConst(pending)) {
+        cache.insertImage(card.name, card.image);
+    }
+    pending.clear();
+}
+
+QImage CardCache::render(QSvgRenderer *renderer, const QString &element, const QSize &size) {
+    CC_TRACE_SPAN("CardCache::render");
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    renderer->render(&painter, element, QRectF(QPointF(), size));
+    return image;
+}
@@ -0,0 +1,100 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_CARDCACHE_HPP
+#define CARD_COUNTER_CARDCACHE_HPP
+
+// Qt
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+#include <QTimer>
+// KF
+#include <KImageCache>
+
+class QSvgRenderer;
+
+class CardTheme;
+
+/**
+ * @brief The CardCache class keeps the rasterized cards of the card themes on disk.
+ *
+ * The cards live in a KImageCache, a memory-mapped file in the user cache directory shared by all running instances,
+ * under the hash of the theme file, the element id, the size in device pixels and the device pixel ratio. A later launch,
+ * or a second instance, at the same size copies the cards instead of rendering the SVG again. Recently used cards are
+ * additionally kept as pixmaps in memory, with their device pixel ratio set, so painting them copies nothing. The
+ * cache is only used from the GUI thread.
+ *
+ * A newly rendered card is only kept in memory at first. It is written to the file once no card was rendered for a
+ * while, so resizing the window neither encodes images while painting nor fills the file with sizes shown only for a
+ * moment. Of an element rendered at several sizes in the meantime, only the last one is written.
+ */
+class CardCache {
+public:
+    /**
+     * @brief Returns the cache of the application.
+     * @return The CardCache instance.
+     */
+    static CardCache *instance();
+
+    /**
+     * @brief Returns an element of a theme, rendered only if it is not cached yet.
+     * @param theme The theme; its cards are only kept in memory if the theme file is unknown.
+     * @param element The index of the element in the theme.
+     * @param size The size in device-independent pixels.
+     * @param devicePixelRatio The device pixel ratio of the screen.
+     * @return The pixmap, with the given device pixel ratio.
+     */
+    QPixmap pixmap(const CardTheme *theme, qint32 element, const QSize &size, qreal devicePixelRatio);
+
+private:
+    CardCache();
+
+    /**
+     * @brief Renders an element.
+     * @param renderer The renderer of the theme.
+     * @param element The id of the element.
+     * @param size The size in device pixels.
+     * @return The image.
+     */
+    static QImage render(QSvgRenderer *renderer, const QString &element, const QSize &size);
+
+    /**
+     * @brief Writes the cards rendered since the last write to the cache file.
+     */
+    void persist();
+
+    /**
+     * @brief A rendered card waiting to be written to the cache file.
+     */
+    struct Pending {
+        QString name; ///< The name of the card in the cache file.
+        QImage image; ///< The rendered card.
+    };
+
+    static constexpr qint32 settleMsecs = 500; ///< The quiet time after the last render before cards are written.
+
+    KImageCache cache; ///< The shared cache file.
+    QCache<quint64, QPixmap> pixmaps; ///< The recently used cards by theme, element and size, the cost is in KiB.
+    QHash<quint64, Pending> pending; ///< The cards not written yet by theme, element and ratio, without the size.
+    QTimer settle; ///< Restarted by every render, writes the pending cards when it fires.
+};
+
+#endif //CARD_COUNTER_CARDCACHE_HPP
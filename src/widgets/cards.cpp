@@ -18,34 +18,63 @@
  *
 */
 
+// std
+#include <algorithm>
+#include <numeric>
 // Qt
 #include <QRandomGenerator>
-#include <QSvgRenderer>
 #include <QPainter>
+#include <QElapsedTimer>
 // own
 #include "cards.hpp"
+#include "cardcache.hpp"
+#include "cardtheme.hpp"
+#include "src/perf/tracer.hpp"
+#include "src/perf/framestats.hpp"
 
 QList<qint32> Cards::shuffleCards(qint32 deckCount, qint32 shuffleCoefficient) {
-    QList<qint32> deck = generateDeck(deckCount);
-    qint32 threshold = deck.size() / (deckCount * shuffleCoefficient);
-    bool flag;
-
-    do {
-        flag = false;
-        std::shuffle(deck.begin(), deck.end(), *QRandomGenerator::global());
-        qint32 lastJokerIndex = -1;
-        for (int i = 0; i < deck.size(); i++) {
-            if (isJoker(deck[i])) {
-                if (i - lastJokerIndex < threshold) {
-                    flag = true;
-                    break;
-                }
-                lastJokerIndex = i;
-            }
-        }
-    } while (flag);
+    return shuffleCards(deckCount, *QRandomGenerator::global(), shuffleCoefficient);
+}
 
-    return deck;
+QList<qint32> Cards::shuffleCards(qint32 deckCount, QRandomGenerator &generator, qint32 shuffleCoefficient) {
+    CC_TRACE_SPAN("Cards::shuffleCards");
+    const QList<qint32> deck = generateDeck(deckCount);
+    QVector<qint32> cards;
+    QVector<qint32> jokers;
+    for (qint32 id: deck) {
+        (isJoker(id) ? jokers : cards).push_back(id);
+    }
+    std::shuffle(cards.begin(), cards.end(), generator);
+    std::shuffle(jokers.begin(), jokers.end(), generator);
+
+    // Every joker has to be at least threshold cards after the previous one (and the start). Removing the
+    // mandatory gaps leaves free slots in which the joker positions are uniform, which is the distribution
+    // reshuffling until the spacing holds would give, without the attempts growing exponentially with the decks.
+    const qint32 size = deck.size();
+    const qint32 jokerCount = jokers.size();
+    qint32 gap = size / (deckCount * shuffleCoefficient) - 1;
+    if (jokerCount) {
+        gap = qBound(0, gap, (size - jokerCount) / jokerCount);
+    }
+    QVector<qint32> slots(size - jokerCount * gap);
+    std::iota(slots.begin(), slots.end(), 0);
+    for (qint32 j = 0; j < jokerCount; j++) {
+        std::swap(slots[j], slots[j + qint32(generator.bounded(quint32(slots.size() - j)))]);
+    }
+    std::sort(slots.begin(), slots.begin() + jokerCount);
+
+    QList<qint32> shuffled;
+    shuffled.reserve(size);
+    qint32 nextJoker = 0;
+    qint32 nextCard = 0;
+    for (qint32 i = 0; i < size; i++) {
+        if (nextJoker < jokerCount && i == slots[nextJoker] + (nextJoker + 1) * gap) {
+            shuffled.append(jokers[nextJoker++]);
+        } else {
+            shuffled.append(cards[nextCard++]);
+        }
+    }
+    return shuffled;
 }
 
 QString Cards::cardName(qint32 id, qint32 standard) {
@@ -140,30 +169,47 @@ qint32 Cards::getSuit(qint32 id) {
 
 void Cards::paintEvent(QPaintEvent *event) {
     Q_UNUSED(event)
+    CC_TRACE_SPAN("Cards::paintEvent");
+    FrameStats *stats = FrameStats::instance();
+    QElapsedTimer timer;
+    if (stats->isEnabled()) {
+        timer.start();
+    }
 
-    if (m_renderer->isValid() && m_renderer->elementExists(svgName)) {
+    if (element != -1 && theme->element(element).exists) {
         QPainter painter(this);
-        m_renderer->render(&painter, svgName);
+        painter.drawPixmap(rect(), CardCache::instance()->pixmap(theme, element, size(), devicePixelRatioF()));
 //        qDebug()<<m_renderer->aspectRatioMode();
 //        if (false) {
 //            painter.setPen(QPen(Qt::red, 5));
 //            painter.drawRoundedRect(rect(), 19, 19);
 //        }
     }
+    if (timer.isValid()) {
+        stats->addPaint(timer.nsecsElapsed());
+    }
 }
 
 Cards::Cards(QSvgRenderer *renderer, QWidget *parent)
-        : QWidget(parent), svgName("back"), currentCardID(-1), m_renderer(renderer) {
-    setFixedSize(renderer->boundsOnElement("back").size().toSize());
+        : QWidget(parent), element(CardTheme::Back), currentCardID(-1), theme(CardTheme::forRenderer(renderer)) {
+    setFixedSize(theme->cardSize().toSize());
 }
 
 void Cards::setId(qint32 id) {
     currentCardID = id;
-    setName(cardName(currentCardID));
+    element = CardTheme::cardIndex(currentCardID);
 }
 
 void Cards::setName(QString name) {
-    svgName = std::move(name);
+    element = theme->indexOf(name);
+}
+
+void Cards::setElement(qint32 index) {
+    element = index;
+}
+
+void Cards::showFace() {
+    element = CardTheme::cardIndex(currentCardID);
 }
 
 QString Cards::getCardNameByCurrentId(qint32 standard) const {
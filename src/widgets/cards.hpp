@@ -26,6 +26,10 @@
 
 class QSvgRenderer;
 
+class QRandomGenerator;
+
+class CardTheme;
+
 /**
  * @brief The Cards class represents a playing card with a given ID.
  *
@@ -56,6 +60,17 @@ public:
      */
     void setName(QString name);
 
+    /**
+     * @brief Shows an element of the theme, e.g. one of the backs, instead of the current card.
+     * @param index The index of the element in the CardTheme.
+     */
+    void setElement(qint32 index);
+
+    /**
+     * @brief Shows the face of the current card again, after a back was shown.
+     */
+    void showFace();
+
     /**
      * @brief An enumeration representing the colours of the card (black or red).
      */
@@ -102,6 +117,15 @@ public:
      */
     static QList<qint32> shuffleCards(qint32 deckCount, qint32 shuffleCoefficient = 2);
 
+    /**
+     * @brief Generates a shuffled deck of cards from the given random generator, e.g. a seeded one.
+     * @param deckCount The number of decks to use in the shuffle.
+     * @param generator The source of randomness.
+     * @param shuffleCoefficient The number of times to shuffle the deck (default: 2).
+     * @return A QList containing the IDs of the shuffled cards.
+     */
+    static QList<qint32> shuffleCards(qint32 deckCount, QRandomGenerator &generator, qint32 shuffleCoefficient = 2);
+
     static QList<qint32> generateDeck(qint32 deckCount);
 
     /**
@@ -184,10 +208,10 @@ public:
 
 
 private:
-    QString svgName; ///< The name of the SVG file used to render the cards.
+    qint32 element; ///< The index of the shown element in the theme, -1 for none.
     qint32 currentCardID; ///< The ID of the current card being displayed.
 
-    QSvgRenderer *m_renderer; ///< The renderer used to draw the cards.
+    const CardTheme *theme; ///< The theme used to draw the cards.
 };
 
 
@@ -0,0 +1,132 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSvgRenderer>
+// own
+#include "cardtheme.hpp"
+#include "cards.hpp"
+#include "src/perf/tracer.hpp"
+
+namespace {
+    // the number of themes built so far
+    qint32 built = 0;
+}
+
+const CardTheme *CardTheme::load(QSvgRenderer *renderer, const QString &path) {
+    CardTheme *theme = build(renderer);
+    QFile file(path);
+    QCryptographicHash sha1(QCryptographicHash::Sha1);
+    if (theme->hash.isEmpty() && file.open(QIODevice::ReadOnly) && sha1.addData(&file)) {
+        // the contents and not the path, so an updated theme never shows cached cards of the old one
+        theme->hash = QString::fromLatin1(sha1.result().toHex().left(16));
+    }
+    return theme;
+}
+
+const CardTheme *CardTheme::forRenderer(QSvgRenderer *renderer) {
+    return build(renderer);
+}
+
+CardTheme *CardTheme::build(QSvgRenderer *renderer) {
+    CardTheme *&theme = themes()[renderer];
+    if (!theme) {
+        theme = new CardTheme(renderer, built++);
+    }
+    return theme;
+}
+
+qint32 CardTheme::cardIndex(qint32 id) {
+    const qint32 rank = Cards::getRank(id);
+    const qint32 suit = Cards::getSuit(id);
+    if (id < 0 || rank > Cards::Rank::King || suit > Cards::Suit::Spades) {
+        return -1;
+    }
+    return 14 * suit + rank;
+}
+
+qint32 CardTheme::indexOf(const QString &id) const {
+    return indices.value(id, -1);
+}
+
+const CardTheme::Element &CardTheme::element(qint32 index) const {
+    return elements[index];
+}
+
+QSizeF CardTheme::cardSize() const {
+    return elements[Back].bounds.size();
+}
+
+QSvgRenderer *CardTheme::renderer() const {
+    return m_renderer;
+}
+
+const QString &CardTheme::fileHash() const {
+    return hash;
+}
+
+qint32 CardTheme::serial() const {
+    return number;
+}
+
+CardTheme::CardTheme(QSvgRenderer *renderer, qint32 serial)
+        : m_renderer(renderer), number(serial), elements(ElementCount) {
+    CC_TRACE_SPAN("CardTheme::build");
+    const bool valid = renderer->isValid();
+    const bool standardAce = valid && renderer->elementExists(QStringLiteral("ace_club"));
+    const bool standardJoker = valid && renderer->elementExists(QStringLiteral("red_joker"));
+    for (qint32 suit = Cards::Suit::Clubs; suit <= Cards::Suit::Spades; suit++) {
+        for (qint32 rank = Cards::Rank::Joker; rank <= Cards::Rank::King; rank++) {
+            QString id;
+            if (rank == Cards::Rank::Joker) {
+                if (suit > Cards::Colour::Red) {
+                    continue;
+                }
+                id = Cards::getColourName(suit) + Cards::getRankName(rank, standardJoker);
+            } else {
+                id = Cards::getRankName(rank, rank != Cards::Rank::Ace || standardAce) + Cards::getSuitName(suit);
+            }
+            elements[14 * suit + rank].id = id;
+        }
+    }
+    elements[Back].id = QStringLiteral("back");
+    elements[BlueBack].id = QStringLiteral("blue_back");
+    elements[GreenBack].id = QStringLiteral("green_back");
+    elements[RedBack].id = QStringLiteral("red_back");
+
+    for (qint32 index = 0; index < ElementCount; index++) {
+        Element &element = elements[index];
+        if (element.id.isEmpty()) {
+            continue;
+        }
+        indices.insert(element.id, index);
+        element.exists = valid && renderer->elementExists(element.id);
+        if (element.exists) {
+            element.bounds = renderer->boundsOnElement(element.id);
+        }
+    }
+}
+
+QHash<QSvgRenderer *, CardTheme *> &CardTheme::themes() {
+    static QHash<QSvgRenderer *, CardTheme *> themes;
+    return themes;
+}
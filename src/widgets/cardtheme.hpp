@@ -0,0 +1,150 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_CARDTHEME_HPP
+#define CARD_COUNTER_CARDTHEME_HPP
+
+// Qt
+#include <QHash>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+class QSvgRenderer;
+
+/**
+ * @brief The CardTheme class holds the elements of a card theme, looked up once when the theme is loaded.
+ *
+ * Every card and back has a fixed integer index, so widgets keep the index of what they show and painting never looks
+ * up an element by its name. Themes disagree on a few names: the ace is either "ace" or "1" and the joker either
+ * "joker" or "jocker", so both are tried and the one the theme has is used.
+ */
+class CardTheme {
+public:
+    /**
+     * @brief The indices of the backs, after the 56 indices of the cards.
+     */
+    enum Backs {
+        Back = 56, /**< The plain back. */
+        BlueBack, /**< The blue back. */
+        GreenBack, /**< The green back. */
+        RedBack, /**< The red back. */
+        ElementCount /**< The number of indices. */
+    };
+
+    /**
+     * @brief An element of the theme.
+     */
+    struct Element {
+        QString id; ///< The id of the element in the SVG file.
+        QRectF bounds; ///< The bounds of the element.
+        bool exists = false; ///< Whether the theme has the element.
+    };
+
+    /**
+     * @brief Returns the table of the theme of a renderer and remembers the theme file, so its cards can be cached on
+     * disk.
+     * @param renderer The renderer of the theme.
+     * @param path The path of the theme file.
+     * @return The theme, owned by the application.
+     */
+    static const CardTheme *load(QSvgRenderer *renderer, const QString &path);
+
+    /**
+     * @brief Returns the table of the theme of a renderer, built on the first call.
+     * @param renderer The renderer of the theme.
+     * @return The theme, owned by the application.
+     */
+    static const CardTheme *forRenderer(QSvgRenderer *renderer);
+
+    /**
+     * @brief Returns the index of a card.
+     * @param id The id of the card, as in Cards.
+     * @return The index, or -1 for an id that is no card.
+     */
+    static qint32 cardIndex(qint32 id);
+
+    /**
+     * @brief Returns the index of an element given by its id.
+     * @param id The id of the element in the SVG file.
+     * @return The index, or -1 if the id is no card or back.
+     */
+    qint32 indexOf(const QString &id) const;
+
+    /**
+     * @brief Returns an element.
+     * @param index The index of the element.
+     * @return The element.
+     */
+    const Element &element(qint32 index) const;
+
+    /**
+     * @brief Returns the size of a card, the one of the plain back.
+     * @return The size in the units of the SVG file.
+     */
+    QSizeF cardSize() const;
+
+    /**
+     * @brief Returns the renderer of the theme.
+     * @return The renderer.
+     */
+    QSvgRenderer *renderer() const;
+
+    /**
+     * @brief Returns the hash of the theme file.
+     * @return The hexadecimal hash, empty if the file is unknown.
+     */
+    const QString &fileHash() const;
+
+    /**
+     * @brief Returns a number identifying the theme among the loaded ones.
+     * @return The number, from 0 on.
+     */
+    qint32 serial() const;
+
+private:
+    /**
+     * @brief Looks up all elements of a theme.
+     * @param renderer The renderer of the theme.
+     * @param serial The number of the theme.
+     */
+    CardTheme(QSvgRenderer *renderer, qint32 serial);
+
+    /**
+     * @brief Returns the theme of a renderer, built on the first call.
+     * @param renderer The renderer of the theme.
+     * @return The theme, owned by the application.
+     */
+    static CardTheme *build(QSvgRenderer *renderer);
+
+    /**
+     * @brief Returns the themes of all renderers.
+     * @return The themes by renderer.
+     */
+    static QHash<QSvgRenderer *, CardTheme *> &themes();
+
+    QSvgRenderer *m_renderer; ///< The renderer of the theme.
+    QString hash; ///< The hash of the theme file, empty if the file is unknown.
+    qint32 number; ///< The number identifying the theme.
+    QVector<Element> elements; ///< The elements by index.
+    QHash<QString, qint32> indices; ///< The index of every element id.
+};
+
+#endif //CARD_COUNTER_CARDTHEME_HPP
@@ -20,40 +20,53 @@
 
 // Qt
 #include <QBoxLayout>
+#include <QPainter>
 #include <QPushButton>
+#include <QResizeEvent>
+#include <QVariantAnimation>
 // own
 #include "carousel.hpp"
+#include "src/perf/tracer.hpp"
 
-Carousel::Carousel(QSizeF aspectRatio, QWidget *parent) : QWidget(parent), ratio(aspectRatio) {
+namespace {
+    // the gap between two items, the default spacing of a box layout
+    const qint32 spacing = 6;
+    // enough for every card of a few decks at a typical size
+    const qint32 cachedKiB = 32 * 1024;
+}
+
+Carousel::Carousel(QSizeF aspectRatio, QWidget *parent) : QWidget(parent), pixmaps(cachedKiB), ratio(aspectRatio) {
 
     auto *boxLayout = new QHBoxLayout(this);
-    auto *carouselBox = new QWidget;
-    carouselBox->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
-    carousel = new QHBoxLayout();
-    carouselBox->setLayout(carousel);
+    viewport = new QWidget;
+    viewport->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Minimum);
+    viewport->installEventFilter(this);
 
     auto *back = new QPushButton();
     back->setIcon(QIcon::fromTheme("draw-arrow-back"));
     back->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Minimum);
-    connect(back, &QPushButton::clicked, [=]() {
-        idx = (idx + widgets.size() - 1) % widgets.size();
-        updateLayout();
-    });
+    connect(back, &QPushButton::clicked, [=]() { scrollBy(-1); });
 
     auto *next = new QPushButton();
     next->setIcon(QIcon::fromTheme("draw-arrow-forward"));
     next->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Minimum);
-    connect(next, &QPushButton::clicked, [=]() {
-        idx = (idx + 1) % widgets.size();
-        updateLayout();
-    });
+    connect(next, &QPushButton::clicked, [=]() { scrollBy(1); });
 
     boxLayout->addWidget(back);
-    boxLayout->addStretch();
-    boxLayout->addWidget(carouselBox);
-    boxLayout->addStretch();
+    boxLayout->addWidget(viewport);
     boxLayout->addWidget(next);
 
+    slide = new QVariantAnimation(this);
+    slide->setStartValue(0.0);
+    slide->setEndValue(1.0);
+    slide->setDuration(180);
+    slide->setEasingCurve(QEasingCurve::OutCubic);
+    connect(slide, &QVariantAnimation::valueChanged, viewport, QOverload<>::of(&QWidget::update));
+    connect(slide, &QVariantAnimation::finished, this, [=]() {
+        slideStrip.clear();
+        setCurrentIndex(idx + slideSteps);
+    });
+
     updateProps(size());
 }
 
@@ -64,37 +77,218 @@ void Carousel::resizeEvent(QResizeEvent *event) {
 
 }
 
+bool Carousel::eventFilter(QObject *watched, QEvent *event) {
+    if (watched == viewport) {
+        if (event->type() == QEvent::Resize) {
+            updateLayout();
+        } else if (event->type() == QEvent::Paint && !slideStrip.isEmpty()) {
+            paintSlide();
+            return true;
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
 void Carousel::addWidget(QWidget *widget) {
     connect(this, &Carousel::itemResized, widget, [widget](QSize newFixedSize) {
         widget->setFixedSize(newFixedSize);
         widget->update();
     });
+    widget->setParent(viewport);
+    widget->hide();
+    if (itemSize.isValid()) {
+        widget->setFixedSize(itemSize);
+    }
     widgets.push_back(widget);
+    // a dozen widgets added in a row are laid out once
+    scheduleLayout();
+}
+
+void Carousel::setItems(qint32 count, std::function<QWidget *()> create, std::function<void(QWidget *, qint32)> bind) {
+    slide->stop();
+    slideStrip.clear();
+    for (QWidget *view: active) {
+        delete view;
+    }
+    qDeleteAll(pool);
+    active.clear();
+    pool.clear();
+    pixmaps.clear();
+    itemCount = count;
+    createView = std::move(create);
+    bindView = std::move(bind);
+    idx = 0;
     updateProps(size());
 }
 
+void Carousel::refreshItem(qint32 index) {
+    if (!bindView) {
+        return;
+    }
+    pixmaps.remove(index);
+    QWidget *view = active.value(index);
+    if (view) {
+        bindView(view, index);
+    }
+}
+
+qint32 Carousel::count() const {
+    return bindView ? itemCount : widgets.size();
+}
+
+qint32 Carousel::currentIndex() const {
+    return idx;
+}
+
+void Carousel::setCurrentIndex(qint32 index) {
+    const qint32 items = count();
+    idx = items ? (index % items + items) % items : 0;
+    updateLayout();
+}
+
+void Carousel::scrollBy(qint32 steps) {
+    if (!count() || !columnCount || !steps) {
+        return;
+    }
+    if (slide->state() == QAbstractAnimation::Running) {
+        // a click during the animation completes it first
+        slide->stop();
+        slideStrip.clear();
+        setCurrentIndex(idx + slideSteps);
+    }
+    CC_TRACE_SPAN("Carousel::scrollBy");
+    slideSteps = steps;
+    const qint32 first = qMin(idx, idx + steps);
+    for (qint32 i = 0; i < columnCount + qAbs(steps); i++) {
+        slideStrip.push_back(pixmapOf(((first + i) % count() + count()) % count()));
+    }
+    for (QWidget *view: active) {
+        view->hide();
+    }
+    slide->start();
+}
+
 void Carousel::updateProps(QSize size) {
     QSizeF itemSize = QSizeF(size.height() * ratio.width() / ratio.height(), size.height());
-    columnCount = qMin(widgets.size(), qint32(0.95 * size.width() / itemSize.width()));
+    columnCount = qMin(count(), qint32(0.95 * size.width() / itemSize.width()));
     updateLayout(0.9 * size.height() / ratio.height());
 }
 
 void Carousel::updateLayout(double newScale) {
-    while (carousel->count()) {
-        QLayoutItem *item = carousel->takeAt(0);
-        item->widget()->hide();
-        delete item;
-    }
-
     if (newScale > 0) {
         QSizeF newFixedSize(ratio.width() * newScale, ratio.height() * newScale);
-        emit itemResized(newFixedSize.toSize());
+        if (newFixedSize.toSize() != itemSize) {
+            itemSize = newFixedSize.toSize();
+            // like a box layout of the visible items, the viewport is at least one item high
+            viewport->setMinimumHeight(itemSize.height());
+            pixmaps.clear();
+            for (QWidget *view: active) {
+                view->setFixedSize(itemSize);
+            }
+            for (QWidget *view: pool) {
+                view->setFixedSize(itemSize);
+            }
+            emit itemResized(itemSize);
+        }
+    }
+    if (!slideStrip.isEmpty()) {
+        return;
     }
 
+    // the views of items staying visible are only moved, the others are hidden and their views recycled
+    const qint32 items = count();
+    QHash<qint32, QWidget *> visible;
     for (qint32 i = 0; i < columnCount; i++) {
-        QWidget *item = widgets[(idx + i) % widgets.size()];
-        carousel->addWidget(item);
-        item->show();
+        const qint32 index = (idx + i) % items;
+        if (active.contains(index)) {
+            visible.insert(index, active.take(index));
+        }
+    }
+    for (QWidget *view: active) {
+        view->hide();
+        if (bindView) {
+            pool.push_back(view);
+        }
+    }
+    const qint32 x = firstItemX();
+    const qint32 y = (viewport->height() - itemSize.height()) / 2;
+    for (qint32 i = 0; i < columnCount; i++) {
+        const qint32 index = (idx + i) % items;
+        QWidget *view = visible.value(index);
+        if (!view) {
+            if (bindView) {
+                view = acquireView();
+                bindView(view, index);
+            } else {
+                view = widgets[index];
+            }
+            visible.insert(index, view);
+        }
+        view->move(x + i * (itemSize.width() + spacing), y);
+        view->show();
+    }
+    active = visible;
+}
+
+void Carousel::scheduleLayout() {
+    if (layoutPending) {
+        return;
     }
+    layoutPending = true;
+    QMetaObject::invokeMethod(this, [=]() {
+        layoutPending = false;
+        updateProps(size());
+    }, Qt::QueuedConnection);
 }
 
+QWidget *Carousel::acquireView() {
+    if (!pool.isEmpty()) {
+        return pool.takeLast();
+    }
+    QWidget *view = createView();
+    view->setParent(viewport);
+    view->setFixedSize(itemSize);
+    view->hide();
+    return view;
+}
+
+QPixmap Carousel::pixmapOf(qint32 index) {
+    if (!bindView) {
+        // added widgets change without telling the carousel, so they are grabbed every time
+        return widgets[index]->grab();
+    }
+    if (const QPixmap *cached = pixmaps.object(index)) {
+        return *cached;
+    }
+    QPixmap pixmap;
+    if (QWidget *view = active.value(index)) {
+        pixmap = view->grab();
+    } else {
+        QWidget *view = acquireView();
+        bindView(view, index);
+        pixmap = view->grab();
+        pool.push_back(view);
+    }
+    const qint32 cost = qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    pixmaps.insert(index, new QPixmap(pixmap), cost);
+    return pixmap;
+}
+
+void Carousel::paintSlide() {
+    QPainter painter(viewport);
+    const qint32 pitch = itemSize.width() + spacing;
+    const double progress = slide->currentValue().toDouble();
+    // the strip starts at the lower of the old and the new first item
+    const double offset = -(slideSteps > 0 ? 0 : -slideSteps) * pitch - progress * slideSteps * pitch;
+    const qint32 y = (viewport->height() - itemSize.height()) / 2;
+    const qint32 x = firstItemX();
+    painter.setClipRect(QRect(x, 0, columnCount * pitch - spacing, viewport->height()));
+    for (qint32 i = 0; i < slideStrip.size(); i++) {
+        painter.drawPixmap(QPointF(x + offset + i * pitch, y), slideStrip[i]);
+    }
+}
+
+qint32 Carousel::firstItemX() const {
+    const qint32 width = columnCount * itemSize.width() + qMax(0, columnCount - 1) * spacing;
+    return (viewport->width() - width) / 2;
+}
@@ -21,18 +21,28 @@
 #ifndef CARD_COUNTER_CAROUSEL_HPP
 #define CARD_COUNTER_CAROUSEL_HPP
 
+// std
+#include <functional>
 // Qt
 #include <QWidget>
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
 
-class QHBoxLayout;
+class QVariantAnimation;
 
 /**
  * @brief The Carousel class is a widget for displaying a carousel of items.
- * The items are added with addWidget() and the aspect ratio of each item
- * is set with the constructor's `aspectRatio` parameter. The size of the carousel
- * widget is automatically adjusted to fit the aspect ratio and number of items.
+ * The items are either added one by one with addWidget() or described by a count and a function binding an item to a
+ * view with setItems(), and the aspect ratio of each item is set with the constructor's `aspectRatio` parameter. The
+ * size of the carousel widget is automatically adjusted to fit the aspect ratio and number of items.
  * When the size of the carousel changes, the items are automatically resized
  * to fit the new size.
+ *
+ * Only the visible window of items has views. Items given by setItems() share a pool of views, so moving the window by
+ * one item binds a single view to the item coming in, and even a whole shoe needs no more views than fit on screen.
+ * Moving with the arrows slides pixmaps of the items instead of the views; the pixmaps of bound items are cached until
+ * their size changes or refreshItem() is called.
  */
 class Carousel : public QWidget {
 Q_OBJECT
@@ -46,12 +56,56 @@ public:
     explicit Carousel(QSizeF aspectRatio, QWidget *parent = nullptr);
 
     /**
-     * @brief Adds a widget to the carousel.
+     * @brief Adds a widget to the carousel. The widget is its own view and is never bound to another item.
      *
      * @param widget The widget to add.
      */
     void addWidget(QWidget *widget);
 
+    /**
+     * @brief Replaces the items of the carousel by items shown in recycled views, and shows the first one.
+     *
+     * @param count The number of items.
+     * @param create Creates an empty view.
+     * @param bind Shows an item, given by its index, in a view.
+     */
+    void setItems(qint32 count, std::function<QWidget *()> create, std::function<void(QWidget *, qint32)> bind);
+
+    /**
+     * @brief Shows an item given by setItems() again, after its content changed.
+     *
+     * @param index The index of the item.
+     */
+    void refreshItem(qint32 index);
+
+    /**
+     * @brief Returns the number of items.
+     *
+     * @return The number of items.
+     */
+    qint32 count() const;
+
+    /**
+     * @brief Returns the index of the leftmost visible item.
+     *
+     * @return The index of the item.
+     */
+    qint32 currentIndex() const;
+
+    /**
+     * @brief Shows the items from the given one on, without an animation.
+     *
+     * @param index The index of the leftmost item.
+     */
+    void setCurrentIndex(qint32 index);
+
+    /**
+     * @brief Slides the items by the given number of positions.
+     *
+     * @param steps The number of positions, negative to slide back.
+     */
+    void scrollBy(qint32 steps);
+
 protected:
     /**
      * @brief Handles resize events for the carousel widget.
@@ -60,6 +114,8 @@ protected:
      */
     void resizeEvent(QResizeEvent *event) override;
 
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 signals:
 
     /**
@@ -84,11 +140,54 @@ private:
      */
     void updateLayout(double newScale = -1);
 
-    QHBoxLayout *carousel; ///< The layout for the carousel.
+    /**
+     * @brief Updates the layout once control returns to the event loop, however often it is called before.
+     */
+    void scheduleLayout();
+
+    /**
+     * @brief Returns a view for an item given by setItems(), recycled if possible.
+     *
+     * @return The hidden view.
+     */
+    QWidget *acquireView();
+
+    /**
+     * @brief Returns the pixmap of an item, from the cache if it is bound by setItems().
+     *
+     * @param index The index of the item.
+     * @return The pixmap.
+     */
+    QPixmap pixmapOf(qint32 index);
+
+    /**
+     * @brief Paints the sliding pixmaps of a running animation.
+     */
+    void paintSlide();
+
+    /**
+     * @brief Returns the left edge of the first visible item in the viewport.
+     *
+     * @return The x coordinate.
+     */
+    qint32 firstItemX() const;
+
+    QWidget *viewport; ///< The area between the arrows the items are shown in.
     QVector<QWidget *> widgets; ///< The list of widgets in the carousel.
+    qint32 itemCount = 0; ///< The number of items given by setItems().
+    std::function<QWidget *()> createView; ///< Creates an empty view for setItems().
+    std::function<void(QWidget *, qint32)> bindView; ///< Shows an item of setItems() in a view.
+    QHash<qint32, QWidget *> active; ///< The view of every visible item.
+    QVector<QWidget *> pool; ///< The hidden views of setItems() waiting to be bound again.
+    QCache<qint32, QPixmap> pixmaps; ///< The pixmaps of the items of setItems(), the cost is in KiB.
+    QVariantAnimation *slide; ///< The animation sliding the items.
+    qint32 slideSteps = 0; ///< The number of positions the running animation slides.
+    QVector<QPixmap> slideStrip; ///< The pixmaps of all items the running animation passes.
+    QSize itemSize; ///< The current size of an item.
     QSizeF ratio; ///< The aspect ratio of the items in the carousel.
     qint32 columnCount = 0; ///< The number of columns in the carousel.
     qint32 idx = 0; ///< The index of the current item.
+    bool layoutPending = false; ///< Whether a layout update is scheduled.
 };
 
 
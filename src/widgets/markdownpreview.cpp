@@ -0,0 +1,148 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QAbstractTextDocumentLayout>
+#include <QDesktopServices>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QTextDocument>
+#include <QThread>
+#include <QUrl>
+#include <QtConcurrent>
+// own
+#include "markdownpreview.hpp"
+#include "src/perf/tracer.hpp"
+
+namespace {
+    // about a hundred pages of notes
+    const qint32 cachedCharacters = 1 << 20;
+}
+
+MarkdownPreview::MarkdownPreview(QWidget *parent) : QWidget(parent), layouts(cachedCharacters) {
+    setMouseTracking(true);
+    watcher = new QFutureWatcher<QSharedPointer<QTextDocument>>(this);
+    connect(watcher, &QFutureWatcher<QSharedPointer<QTextDocument>>::finished, this, [=]() {
+        const QSharedPointer<QTextDocument> result = watcher->result();
+        auto *layout = new Layout(running);
+        layout->document = result;
+        layouts.insert(runningKey, layout, qMax(qint32(1), running.markdown.size()));
+        if (stale) {
+            stale = false;
+            render();
+        } else {
+            display(result);
+        }
+    });
+}
+
+void MarkdownPreview::setMarkdown(const QString &key, const QString &markdown) {
+    this->key = key;
+    source = markdown;
+    render();
+}
+
+QString MarkdownPreview::markdown() const {
+    return source;
+}
+
+QSize MarkdownPreview::sizeHint() const {
+    if (!document) {
+        return QWidget::sizeHint();
+    }
+    return document->documentLayout()->documentSize().toSize();
+}
+
+void MarkdownPreview::paintEvent(QPaintEvent *event) {
+    if (!document) {
+        return;
+    }
+    QPainter painter(this);
+    painter.setClipRect(event->rect());
+    QAbstractTextDocumentLayout::PaintContext context;
+    context.palette = palette();
+    context.clip = event->rect();
+    document->documentLayout()->draw(&painter, context);
+}
+
+void MarkdownPreview::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    if (event->size().width() != event->oldSize().width()) {
+        render();
+    }
+}
+
+void MarkdownPreview::mouseMoveEvent(QMouseEvent *event) {
+    const bool link = document && !document->documentLayout()->anchorAt(event->pos()).isEmpty();
+    setCursor(link ? Qt::PointingHandCursor : Qt::ArrowCursor);
+    QWidget::mouseMoveEvent(event);
+}
+
+void MarkdownPreview::mouseReleaseEvent(QMouseEvent *event) {
+    if (document && event->button() == Qt::LeftButton) {
+        const QString anchor = document->documentLayout()->anchorAt(event->pos());
+        if (!anchor.isEmpty()) {
+            QDesktopServices::openUrl(QUrl(anchor));
+        }
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void MarkdownPreview::render() {
+    const Layout *cached = layouts.object(key);
+    if (cached && cached->markdown == source && cached->width == width()) {
+        stale = false;
+        display(cached->document);
+        return;
+    }
+    if (watcher->isRunning()) {
+        stale = true;
+        return;
+    }
+    runningKey = key;
+    running = {source, width(), nullptr};
+    watcher->setFuture(QtConcurrent::run(&MarkdownPreview::layout, source, width(), font(), thread()));
+}
+
+QSharedPointer<QTextDocument> MarkdownPreview::layout(const QString &markdown, qint32 width, const QFont &font,
+                                                      QThread *target) {
+    CC_TRACE_SPAN("MarkdownPreview::layout");
+    auto *document = new QTextDocument();
+    document->setDefaultFont(font);
+    document->setDocumentMargin(0);
+    document->setMarkdown(markdown);
+    document->setTextWidth(width);
+    // lays out every block here, instead of on the first paint
+    document->documentLayout()->documentSize();
+    document->moveToThread(target);
+    return QSharedPointer<QTextDocument>(document, &QObject::deleteLater);
+}
+
+void MarkdownPreview::display(const QSharedPointer<QTextDocument> &document) {
+    if (this->document == document) {
+        return;
+    }
+    const QSize previous = sizeHint();
+    this->document = document;
+    if (sizeHint() != previous) {
+        updateGeometry();
+    }
+    update();
+}
@@ -0,0 +1,116 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_MARKDOWNPREVIEW_HPP
+#define CARD_COUNTER_MARKDOWNPREVIEW_HPP
+
+// Qt
+#include <QWidget>
+#include <QCache>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+
+class QTextDocument;
+
+class QThread;
+
+/**
+ * @brief The MarkdownPreview class shows a Markdown text, parsed and laid out in the background.
+ *
+ * Every text is shown under a key, the name of its strategy, and the laid out document of the last text of every key
+ * is cached, so switching back to a strategy shows it at once. A new text or width is parsed by a worker thread while
+ * the previous document stays on screen; changes arriving while the worker runs are merged into one more run.
+ */
+class MarkdownPreview : public QWidget {
+Q_OBJECT
+public:
+    /**
+     * @brief Constructs an empty preview.
+     * @param parent The parent widget.
+     */
+    explicit MarkdownPreview(QWidget *parent = nullptr);
+
+    /**
+     * @brief Shows a text, from the cache if it was laid out for this key and width before.
+     * @param key The key of the text.
+     * @param markdown The text in Markdown.
+     */
+    void setMarkdown(const QString &key, const QString &markdown);
+
+    /**
+     * @brief Returns the shown text, even if it is still laid out.
+     * @return The text in Markdown.
+     */
+    QString markdown() const;
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    void resizeEvent(QResizeEvent *event) override;
+
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    /**
+     * @brief A laid out text.
+     */
+    struct Layout {
+        QString markdown; ///< The text in Markdown.
+        qint32 width; ///< The width the text was laid out for.
+        QSharedPointer<QTextDocument> document; ///< The document, owned by the GUI thread.
+    };
+
+    /**
+     * @brief Shows the cached layout of the text or starts laying it out.
+     */
+    void render();
+
+    /**
+     * @brief Parses and lays out a text, run by a worker thread.
+     * @param markdown The text in Markdown.
+     * @param width The width of the layout.
+     * @param font The default font.
+     * @param target The thread the document is moved to.
+     * @return The document, deleted later by the thread it was moved to.
+     */
+    static QSharedPointer<QTextDocument> layout(const QString &markdown, qint32 width, const QFont &font,
+                                                QThread *target);
+
+    /**
+     * @brief Shows a laid out document.
+     * @param document The document.
+     */
+    void display(const QSharedPointer<QTextDocument> &document);
+
+    QString key; ///< The key of the shown text.
+    QString source; ///< The shown text in Markdown.
+    QSharedPointer<QTextDocument> document; ///< The document on screen, possibly of an older text.
+    QCache<QString, Layout> layouts; ///< The last layout of every key, the cost is the length of the text.
+    QFutureWatcher<QSharedPointer<QTextDocument>> *watcher; ///< The watcher of the running layout.
+    QString runningKey; ///< The key of the running layout.
+    Layout running; ///< The text and width of the running layout, without a document.
+    bool stale = false; ///< Whether the text or the width changed while the layout ran.
+};
+
+#endif //CARD_COUNTER_MARKDOWNPREVIEW_HPP
@@ -0,0 +1,102 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QEvent>
+#include <QPainter>
+#include <QTimer>
+// KF
+#include <KLocalizedString>
+// own
+#include "perfoverlay.hpp"
+#include "src/perf/framestats.hpp"
+
+PerfOverlay::PerfOverlay(QWidget *parent) : QWidget(parent) {
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    // room for the longest line, so that refreshing never changes the geometry
+    QFontMetrics metrics(font());
+    setFixedSize(metrics.horizontalAdvance(i18n("Slowest card paint: 0000.00 ms")) + 16,
+                 5 * metrics.lineSpacing() + 12);
+    move(8, 8);
+
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &PerfOverlay::refresh);
+    hide();
+}
+
+void PerfOverlay::setVisible(bool visible) {
+    QWidget::setVisible(visible);
+    FrameStats::instance()->setEnabled(visible);
+    if (watchedWindow) {
+        watchedWindow->removeEventFilter(this);
+    }
+    if (visible) {
+        watchedWindow = window();
+        watchedWindow->installEventFilter(this);
+        frames = 0;
+        sinceRefresh.start();
+        raise();
+        refreshTimer->start(500);
+    } else {
+        refreshTimer->stop();
+    }
+}
+
+bool PerfOverlay::eventFilter(QObject *watched, QEvent *event) {
+    // every flush of the backing store of the window is one frame
+    if (watched == watchedWindow && event->type() == QEvent::UpdateRequest) {
+        frames++;
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void PerfOverlay::refresh() {
+    FrameStats *stats = FrameStats::instance();
+    double fps = frames * 1000.0 / qMax(qint64(1), sinceRefresh.restart());
+    frames = 0;
+
+    double hitRate = stats->pixmapHitRate();
+    lines = {
+            i18n("FPS: %1", QString::number(fps, 'f', 1)),
+            i18n("Slowest card paint: %1 ms", QString::number(stats->takeSlowestPaint() / 1e6, 'f', 2)),
+            i18n("Last deal tick: %1 ms", QString::number(stats->lastTick() / 1e6, 'f', 2)),
+            i18n("Pixmap cache hits: %1",
+                 hitRate < 0 ? i18n("n/a") : QStringLiteral("%1%").arg(hitRate * 100, 0, 'f', 1)),
+            i18n("Widgets: %1", parentWidget()->findChildren<QWidget *>().size()),
+    };
+    // slots added since the last refresh are stacked above the overlay
+    raise();
+    update();
+}
+
+void PerfOverlay::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    QFontMetrics metrics(font());
+    qint32 y = 6 + metrics.ascent();
+    for (const auto &line: lines) {
+        painter.drawText(8, y, line);
+        y += metrics.lineSpacing();
+    }
+}
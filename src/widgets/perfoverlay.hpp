@@ -0,0 +1,71 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_PERFOVERLAY_HPP
+#define CARD_COUNTER_PERFOVERLAY_HPP
+
+// Qt
+#include <QWidget>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QStringList>
+
+class QTimer;
+
+/**
+ * @brief The PerfOverlay class is a floating panel showing the frame rate, the slowest card paint,
+ * the last deal tick, the pixmap cache hit rate and the number of widgets of its parent.
+ *
+ * The overlay is not part of any layout and keeps a fixed size, so refreshing it only repaints its own area.
+ */
+class PerfOverlay : public QWidget {
+Q_OBJECT
+public:
+    /**
+     * @brief Constructs the overlay on top of the given parent widget.
+     * @param parent The widget whose statistics are shown.
+     */
+    explicit PerfOverlay(QWidget *parent);
+
+    /**
+     * @brief Shows or hides the overlay and enables the statistics while it is visible.
+     * @param visible Whether the overlay should be visible.
+     */
+    void setVisible(bool visible) override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    /**
+     * @brief Reads the current statistics and repaints the overlay.
+     */
+    void refresh();
+
+    QTimer *refreshTimer; ///< The timer updating the shown statistics.
+    QPointer<QWidget> watchedWindow; ///< The top-level window whose frames are counted.
+    QStringList lines; ///< The lines of text currently shown.
+    qint32 frames = 0; ///< The number of frames since the last refresh.
+    QElapsedTimer sinceRefresh; ///< The time elapsed since the last refresh.
+};
+
+#endif //CARD_COUNTER_PERFOVERLAY_HPP
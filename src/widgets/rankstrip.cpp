@@ -0,0 +1,309 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+// Qt
+#include <QElapsedTimer>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QSpinBox>
+// own
+#include "rankstrip.hpp"
+#include "cards.hpp"
+#include "cardcache.hpp"
+#include "cardtheme.hpp"
+#include "src/perf/tracer.hpp"
+#include "src/perf/framestats.hpp"
+
+namespace {
+    // the gap between two cards
+    const qint32 gap = 4;
+    // the width of a card in the size hint
+    const qint32 hintWidth = 60;
+}
+
+RankStrip::RankStrip(QSvgRenderer *renderer, QWidget *parent)
+        : QWidget(parent), theme(CardTheme::forRenderer(renderer)), values(13, 0) {
+    QSizePolicy policy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    policy.setHeightForWidth(true);
+    setSizePolicy(policy);
+    setFocusPolicy(Qt::StrongFocus);
+
+    editor = new QSpinBox(this);
+    editor->setRange(-5, 5);
+    editor->setAlignment(Qt::AlignCenter);
+    editor->hide();
+    connect(editor, QOverload<int>::of(&QSpinBox::valueChanged), this, [=](int value) {
+        if (edited != -1 && values[edited] != value) {
+            values[edited] = value;
+            emit weightsChanged();
+        }
+    });
+    connect(editor, &QSpinBox::editingFinished, this, [=]() {
+        const qint32 rank = edited;
+        edited = -1;
+        // after enter the keyboard continues on the strip, a click elsewhere keeps the focus there
+        if (editor->hasFocus()) {
+            setFocus();
+        }
+        editor->hide();
+        if (rank != -1) {
+            update(weightRect(rank));
+        }
+    });
+}
+
+QVector<qint32> RankStrip::weights() const {
+    return values;
+}
+
+void RankStrip::setWeights(const QVector<qint32> &weights) {
+    if (weights == values || weights.size() != 13) {
+        return;
+    }
+    values = weights;
+    if (edited != -1) {
+        const qint32 rank = edited;
+        edited = -1; // the new value is not an edit
+        editor->setValue(values[rank]);
+        edited = rank;
+    }
+    update();
+    emit weightsChanged();
+}
+
+void RankStrip::setReadOnly(bool readOnly) {
+    this->readOnly = readOnly;
+    if (readOnly && edited != -1) {
+        edited = -1;
+        editor->hide();
+        update();
+    }
+}
+
+void RankStrip::setRange(qint32 minimum, qint32 maximum) {
+    editor->setRange(minimum, maximum);
+}
+
+QSize RankStrip::sizeHint() const {
+    const qint32 width = 13 * hintWidth + 12 * gap;
+    return {width, heightForWidth(width)};
+}
+
+bool RankStrip::hasHeightForWidth() const {
+    return true;
+}
+
+int RankStrip::heightForWidth(int width) const {
+    const qint32 cardWidth = qMax(1, (width - 12 * gap) / 13);
+    const QSizeF ratio = theme->cardSize();
+    return qRound(cardWidth * ratio.height() / ratio.width());
+}
+
+void RankStrip::paintEvent(QPaintEvent *event) {
+    CC_TRACE_SPAN("RankStrip::paintEvent");
+    FrameStats *stats = FrameStats::instance();
+    QElapsedTimer timer;
+    if (stats->isEnabled()) {
+        timer.start();
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    const qreal scale = atlas.devicePixelRatio();
+    for (qint32 rank = 0; rank < 13; rank++) {
+        const QRect card = cardRect(rank);
+        if (!event->rect().intersects(card)) {
+            continue;
+        }
+        const QRectF source(rank * cardSize.width() * scale, 0, cardSize.width() * scale, cardSize.height() * scale);
+        painter.drawPixmap(card, atlas, source);
+        if (rank == current && hasFocus()) {
+            painter.setPen(QPen(palette().color(QPalette::Highlight), 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawRoundedRect(QRectF(card).adjusted(1, 1, -1, -1), 4, 4);
+        }
+        if (rank == edited) {
+            continue;
+        }
+        const QRect weight = weightRect(rank);
+        painter.setPen(palette().color(QPalette::Mid));
+        painter.setBrush(palette().base());
+        painter.drawRoundedRect(weight, 4, 4);
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(weight, Qt::AlignCenter,
+                         values[rank] > 0 ? QStringLiteral("+%1").arg(values[rank]) : QString::number(values[rank]));
+    }
+    if (timer.isValid()) {
+        stats->addPaint(timer.nsecsElapsed());
+    }
+}
+
+void RankStrip::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    renderAtlas();
+    if (edited != -1) {
+        edit(edited);
+    }
+}
+
+void RankStrip::mousePressEvent(QMouseEvent *event) {
+    const qint32 rank = rankAt(event->pos());
+    if (rank != -1 && event->button() == Qt::LeftButton) {
+        setCurrent(rank);
+        if (!readOnly) {
+            edit(rank);
+        }
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void RankStrip::wheelEvent(QWheelEvent *event) {
+    const qint32 rank = rankAt(event->position().toPoint());
+    const qint32 steps = event->angleDelta().y() / 120;
+    if (rank == -1 || readOnly || !steps) {
+        QWidget::wheelEvent(event);
+        return;
+    }
+    stepWeight(rank, steps);
+    event->accept();
+}
+
+void RankStrip::keyPressEvent(QKeyEvent *event) {
+    switch (event->key()) {
+        case Qt::Key_Left:
+            setCurrent(current - 1);
+            break;
+        case Qt::Key_Right:
+            setCurrent(current + 1);
+            break;
+        case Qt::Key_Up:
+        case Qt::Key_Down:
+            if (readOnly) {
+                QWidget::keyPressEvent(event);
+                return;
+            }
+            stepWeight(current, event->key() == Qt::Key_Up ? 1 : -1);
+            break;
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+            if (readOnly) {
+                QWidget::keyPressEvent(event);
+                return;
+            }
+            edit(current);
+            break;
+        default:
+            QWidget::keyPressEvent(event);
+            return;
+    }
+    event->accept();
+}
+
+void RankStrip::focusInEvent(QFocusEvent *event) {
+    QWidget::focusInEvent(event);
+    update(cardRect(current));
+}
+
+void RankStrip::focusOutEvent(QFocusEvent *event) {
+    QWidget::focusOutEvent(event);
+    update(cardRect(current));
+}
+
+QRect RankStrip::cardRect(qint32 rank) const {
+    const qint32 left = (width() - (13 * cardSize.width() + 12 * gap)) / 2;
+    return {left + rank * (cardSize.width() + gap), 0, cardSize.width(), cardSize.height()};
+}
+
+QRect RankStrip::weightRect(qint32 rank) const {
+    const QRect card = cardRect(rank);
+    const qint32 height = fontMetrics().height() + 4;
+    const qint32 width = qMin(card.width() - 4, fontMetrics().horizontalAdvance(QStringLiteral("+00")) + 8);
+    return {card.center().x() - width / 2, card.bottom() - height - 4, width, height};
+}
+
+qint32 RankStrip::rankAt(const QPoint &position) const {
+    for (qint32 rank = 0; rank < 13; rank++) {
+        if (cardRect(rank).contains(position)) {
+            return rank;
+        }
+    }
+    return -1;
+}
+
+void RankStrip::renderAtlas() {
+    const qint32 cardWidth = qMax(1, (width() - 12 * gap) / 13);
+    const QSize size(cardWidth, qMin(height(), heightForWidth(width())));
+    if (size == cardSize && !atlas.isNull()) {
+        return;
+    }
+    CC_TRACE_SPAN("RankStrip::renderAtlas");
+    cardSize = size;
+    const qreal scale = devicePixelRatioF();
+    atlas = QPixmap(QSize(13 * cardSize.width(), cardSize.height()) * scale);
+    atlas.setDevicePixelRatio(scale);
+    atlas.fill(Qt::transparent);
+    QPainter painter(&atlas);
+    for (qint32 rank = 0; rank < 13; rank++) {
+        qint32 element = CardTheme::cardIndex(Cards::Rank::Ace + rank);
+        if (!theme->element(element).exists) {
+            element = CardTheme::Back;
+        }
+        const QRectF card(rank * cardSize.width(), 0, cardSize.width(), cardSize.height());
+        painter.drawPixmap(card, CardCache::instance()->pixmap(theme, element, cardSize, scale));
+    }
+}
+
+void RankStrip::edit(qint32 rank) {
+    edited = -1; // setting the value is not an edit
+    editor->setValue(values[rank]);
+    edited = rank;
+    QRect geometry(QPoint(), editor->sizeHint());
+    geometry.moveCenter(weightRect(rank).center());
+    geometry.moveLeft(qBound(0, geometry.left(), width() - geometry.width()));
+    geometry.moveBottom(qMin(geometry.bottom(), height() - 1));
+    editor->setGeometry(geometry);
+    editor->show();
+    editor->setFocus();
+    editor->selectAll();
+    // the badge of the previously edited card shows again
+    update();
+}
+
+void RankStrip::stepWeight(qint32 rank, qint32 steps) {
+    const qint32 value = qBound(editor->minimum(), values[rank] + steps, editor->maximum());
+    if (rank == edited) {
+        editor->setValue(value);
+    } else if (value != values[rank]) {
+        values[rank] = value;
+        update(weightRect(rank));
+        emit weightsChanged();
+    }
+}
+
+void RankStrip::setCurrent(qint32 rank) {
+    rank = qBound(0, rank, 12);
+    if (rank == current) {
+        return;
+    }
+    update(cardRect(current));
+    current = rank;
+    update(cardRect(current));
+}
@@ -0,0 +1,162 @@
+/*
+ *   The GNU General Public License v3.0
+ *
+ *   Copyright (C) 2023 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+*/
+
+#ifndef CARD_COUNTER_RANKSTRIP_HPP
+#define CARD_COUNTER_RANKSTRIP_HPP
+
+// Qt
+#include <QWidget>
+#include <QPixmap>
+#include <QVector>
+
+class QSvgRenderer;
+
+class QSpinBox;
+
+class CardTheme;
+
+/**
+ * @brief The RankStrip class shows the thirteen ranks from ace to king in one row, each with its weight.
+ *
+ * The cards are taken from the CardCache once per size into an atlas that every paint copies from, and all weights
+ * share a single spin box, which is moved over the weight of the clicked card. The wheel changes the weight under the
+ * cursor. With the keyboard, left and right move between the cards, up and down change the weight of the current
+ * card and enter opens the spin box on it.
+ */
+class RankStrip : public QWidget {
+Q_OBJECT
+public:
+    /**
+     * @brief Constructs a strip with all weights zero.
+     * @param renderer The SVG renderer of the card theme.
+     * @param parent The parent widget.
+     */
+    explicit RankStrip(QSvgRenderer *renderer, QWidget *parent = nullptr);
+
+    /**
+     * @brief Returns the weights.
+     * @return The 13 weights from ace to king.
+     */
+    QVector<qint32> weights() const;
+
+    /**
+     * @brief Sets the weights, emitting weightsChanged() once if any differs.
+     * @param weights The 13 weights from ace to king.
+     */
+    void setWeights(const QVector<qint32> &weights);
+
+    /**
+     * @brief Sets whether the weights can be edited.
+     * @param readOnly True to only show the weights.
+     */
+    void setReadOnly(bool readOnly);
+
+    /**
+     * @brief Sets the range of a weight.
+     * @param minimum The lowest weight.
+     * @param maximum The highest weight.
+     */
+    void setRange(qint32 minimum, qint32 maximum);
+
+    QSize sizeHint() const override;
+
+    bool hasHeightForWidth() const override;
+
+    int heightForWidth(int width) const override;
+
+signals:
+
+    /**
+     * @brief Emitted when a weight changed, by the user or by setWeights().
+     */
+    void weightsChanged();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+    void resizeEvent(QResizeEvent *event) override;
+
+    void mousePressEvent(QMouseEvent *event) override;
+
+    void wheelEvent(QWheelEvent *event) override;
+
+    void keyPressEvent(QKeyEvent *event) override;
+
+    void focusInEvent(QFocusEvent *event) override;
+
+    void focusOutEvent(QFocusEvent *event) override;
+
+private:
+    /**
+     * @brief Returns the rectangle of a card.
+     * @param rank The rank from 0 for the ace to 12 for the king.
+     * @return The rectangle in widget coordinates.
+     */
+    QRect cardRect(qint32 rank) const;
+
+    /**
+     * @brief Returns the rectangle of the weight drawn on a card.
+     * @param rank The rank from 0 for the ace to 12 for the king.
+     * @return The rectangle in widget coordinates.
+     */
+    QRect weightRect(qint32 rank) const;
+
+    /**
+     * @brief Returns the card under a point.
+     * @param position The point in widget coordinates.
+     * @return The rank from 0 for the ace to 12 for the king, or -1 if there is no card.
+     */
+    qint32 rankAt(const QPoint &position) const;
+
+    /**
+     * @brief Renders all cards at the current size into the atlas.
+     */
+    void renderAtlas();
+
+    /**
+     * @brief Opens the spin box over the weight of a card.
+     * @param rank The rank from 0 for the ace to 12 for the king.
+     */
+    void edit(qint32 rank);
+
+    /**
+     * @brief Changes the weight of a card within the range, through the spin box if it edits the card.
+     * @param rank The rank from 0 for the ace to 12 for the king.
+     * @param steps The amount to add to the weight.
+     */
+    void stepWeight(qint32 rank, qint32 steps);
+
+    /**
+     * @brief Moves the keyboard to another card.
+     * @param rank The rank from 0 for the ace to 12 for the king, clamped to the strip.
+     */
+    void setCurrent(qint32 rank);
+
+    const CardTheme *theme; ///< The card theme.
+    QVector<qint32> values; ///< The 13 weights from ace to king.
+    QPixmap atlas; ///< All cards side by side at the current size.
+    QSize cardSize; ///< The current size of a card.
+    QSpinBox *editor; ///< The spin box shared by all weights.
+    qint32 edited = -1; ///< The rank the spin box edits, or -1.
+    qint32 current = 0; ///< The rank the keyboard works on.
+    bool readOnly = false; ///< Whether the weights can be edited.
+};
+
+#endif //CARD_COUNTER_RANKSTRIP_HPP